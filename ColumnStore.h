@@ -0,0 +1,596 @@
+#ifndef COLUMNSTORE_H
+#define COLUMNSTORE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.h"
+#include "StaticReflectionV2.h"
+
+// column file: one column per data member of T, rows cut into blocks of block_rows
+//   column_file_header
+//   column_entry[column_count], then the column names
+//   per column: column_block[block_count], then the encoded blocks
+// a reader maps the file and touches the directory plus the blocks of the columns it asks for
+
+namespace static_reflection_v2
+{
+    static_assert(std::endian::native == std::endian::little, "column files are written in host byte order, little endian only");
+
+    enum class column_kind : uint8_t
+    {
+        signed_int,
+        unsigned_int,
+        floating,
+        string
+    };
+
+    enum class column_encoding : uint8_t
+    {
+        plain,      // width bytes per value; strings: varint length + bytes
+        delta,      // integers: zigzag varint of the difference to the previous value
+        dictionary, // strings: varint count, the distinct strings, then a varint index per row
+    };
+
+    inline constexpr char column_file_magic[8] = {'S', 'R', 'C', 'O', 'L', '0', '0', '1'};
+
+    struct column_file_header
+    {
+        char     magic[8];
+        uint32_t column_count;
+        uint32_t block_rows;
+        uint64_t row_count;
+    };
+
+    struct column_entry
+    {
+        uint64_t name_hash;
+        uint64_t blocks_offset; // column_block[block_count]
+        uint32_t block_count;
+        uint16_t name_length;
+        uint8_t  kind;
+        uint8_t  width;
+    };
+
+    // min / max as double: rounding keeps the order, so a range test on them never skips a matching block
+    struct column_block
+    {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t rows;
+        double   min;
+        double   max;
+        uint8_t  encoding;
+        uint8_t  reserved[7];
+    };
+
+    struct column_options
+    {
+        uint32_t block_rows = 65536;
+        bool     compress   = true; // delta / dictionary where they come out smaller than plain
+    };
+
+    template<class FieldType, bool = std::is_enum_v<FieldType>>
+    struct column_storage
+    {
+        using type = std::conditional_t<std::is_same_v<FieldType, bool>, uint8_t, FieldType>;
+    };
+
+    template<class FieldType>
+    struct column_storage<FieldType, true>
+    {
+        using type = std::underlying_type_t<FieldType>;
+    };
+
+    // arithmetic, enum and string members get a column, anything else is left out of the file
+    template<class FieldType>
+    struct column_traits
+    {
+        using storage_type = typename column_storage<FieldType>::type;
+
+        static constexpr bool is_string = !std::is_arithmetic_v<FieldType> && !std::is_enum_v<FieldType> &&
+                                          std::is_convertible_v<const FieldType&, std::string_view> && std::is_assignable_v<FieldType&, std::string_view>;
+        static constexpr bool supported = std::is_arithmetic_v<FieldType> || std::is_enum_v<FieldType> || is_string;
+
+        static constexpr column_kind kind = is_string                                ? column_kind::string
+                                            : std::is_floating_point_v<storage_type> ? column_kind::floating
+                                            : std::is_signed_v<storage_type>         ? column_kind::signed_int
+                                                                                     : column_kind::unsigned_int;
+        static constexpr uint8_t width = is_string ? 0 : uint8_t(sizeof(storage_type));
+    };
+
+    template<class T, class FieldInfo>
+    using column_field_t = std::remove_cvref_t<decltype(std::declval<const T&>().*(std::declval<FieldInfo>().ptr))>;
+
+    // fn(field_info) for every member of T that has a column; groups are left out, their binds share one name
+    template<class T, class Fn>
+    constexpr void for_each_column(Fn&& fn)
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        for_each_tuple(meta_class.member_info_tuple,
+                       [&fn](const auto& field_info) constexpr
+                       {
+                           using field_info_t = std::decay_t<decltype(field_info)>;
+                           if constexpr(!is_member_ptr_group<field_info_t>() && !is_member_func<field_info_t>())
+                           {
+                               if constexpr(column_traits<column_field_t<T, field_info_t>>::supported)
+                                   fn(field_info);
+                           }
+                       });
+    }
+
+    template<class T>
+    constexpr uint32_t column_count()
+    {
+        uint32_t count = 0;
+        for_each_column<T>([&count](const auto&) constexpr { count++; });
+        return count;
+    }
+
+    // not constexpr, so reaching it during constant evaluation is a compile error
+    inline void column_member_not_found() {}
+
+    // name hash of the column of a member, &T::field or a base class member
+    template<class T, auto Field>
+    constexpr uint64_t column_name_hash()
+    {
+        constexpr auto field_ptr = rebase_member_ptr<T>(Field);
+        uint64_t       name_hash = 0;
+        bool           found     = false;
+        for_each_column<T>(
+            [&name_hash, &found, field_ptr](const auto& field_info) constexpr
+            {
+                if constexpr(std::is_same_v<std::decay_t<decltype(field_info.ptr)>, std::decay_t<decltype(field_ptr)>>)
+                {
+                    if(field_info.ptr == field_ptr)
+                    {
+                        name_hash = field_info.field_name_hash;
+                        found     = true;
+                    }
+                }
+            });
+        if(!found)
+            column_member_not_found();
+        return name_hash;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<class Pod>
+    inline void column_put_pod(std::vector<char>& out, const Pod& value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(Pod));
+    }
+
+    template<class Pod>
+    inline Pod column_get_pod(const char* p)
+    {
+        Pod value;
+        std::memcpy(&value, p, sizeof(Pod));
+        return value;
+    }
+
+    inline void column_put_varint(std::vector<char>& out, uint64_t value)
+    {
+        while(value >= 0x80)
+        {
+            out.push_back(char(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(char(value));
+    }
+
+    inline bool column_get_varint(const char*& p, const char* end, uint64_t& value)
+    {
+        value = 0;
+        for(int shift = 0; p < end && shift < 64; shift += 7)
+        {
+            uint8_t byte = uint8_t(*p++);
+            value |= uint64_t(byte & 0x7F) << shift;
+            if(byte < 0x80)
+                return true;
+        }
+        return false;
+    }
+
+    template<class V>
+    inline void column_encode_numbers(std::span<const V> values, bool compress, std::vector<char>& out, column_block& block)
+    {
+        block.min = values.empty() ? 0 : double(*std::min_element(values.begin(), values.end()));
+        block.max = values.empty() ? 0 : double(*std::max_element(values.begin(), values.end()));
+
+        size_t begin = out.size();
+        if constexpr(std::is_integral_v<V>)
+        {
+            if(compress)
+            {
+                uint64_t previous = 0;
+                for(V value: values)
+                {
+                    uint64_t delta = uint64_t(int64_t(value)) - previous;
+                    previous       = uint64_t(int64_t(value));
+                    column_put_varint(out, (delta << 1) ^ uint64_t(int64_t(delta) >> 63));
+                }
+                if(out.size() - begin < values.size_bytes())
+                {
+                    block.encoding = uint8_t(column_encoding::delta);
+                    return;
+                }
+                out.resize(begin);
+            }
+        }
+        const char* bytes = reinterpret_cast<const char*>(values.data());
+        out.insert(out.end(), bytes, bytes + values.size_bytes());
+        block.encoding = uint8_t(column_encoding::plain);
+    }
+
+    inline void column_encode_strings(std::span<const std::string_view> values, bool compress, std::vector<char>& out, column_block& block)
+    {
+        block.min = block.max = 0;
+
+        size_t begin = out.size();
+        if(compress)
+        {
+            std::unordered_map<std::string_view, uint32_t> index_of;
+            std::vector<std::string_view>                  dictionary;
+            for(auto value: values)
+            {
+                if(index_of.try_emplace(value, uint32_t(dictionary.size())).second)
+                    dictionary.push_back(value);
+            }
+            if(dictionary.size() <= values.size() / 2)
+            {
+                column_put_varint(out, dictionary.size());
+                for(auto value: dictionary)
+                {
+                    column_put_varint(out, value.size());
+                    out.insert(out.end(), value.begin(), value.end());
+                }
+                for(auto value: values)
+                    column_put_varint(out, index_of[value]);
+                block.encoding = uint8_t(column_encoding::dictionary);
+                return;
+            }
+        }
+        out.resize(begin);
+        for(auto value: values)
+        {
+            column_put_varint(out, value.size());
+            out.insert(out.end(), value.begin(), value.end());
+        }
+        block.encoding = uint8_t(column_encoding::plain);
+    }
+
+    // the whole file into out
+    template<class T>
+    inline void write_columns(std::span<const T> rows, std::vector<char>& out, const column_options& options = {})
+    {
+        constexpr uint32_t columns     = column_count<T>();
+        const uint32_t     block_rows  = std::max<uint32_t>(1, options.block_rows);
+        const uint32_t     block_count = uint32_t((rows.size() + block_rows - 1) / block_rows);
+
+        size_t             file_begin = out.size();
+        column_file_header header{};
+        std::memcpy(header.magic, column_file_magic, sizeof(header.magic));
+        header.column_count = columns;
+        header.block_rows   = block_rows;
+        header.row_count    = rows.size();
+        column_put_pod(out, header);
+
+        size_t directory = out.size();
+        out.resize(directory + columns * sizeof(column_entry));
+        for_each_column<T>([&out](const auto& field_info) { out.insert(out.end(), field_info.field_name, field_info.field_name + std::strlen(field_info.field_name)); });
+
+        size_t column = 0;
+        for_each_column<T>(
+            [&](const auto& field_info)
+            {
+                using traits = column_traits<column_field_t<T, std::decay_t<decltype(field_info)>>>;
+
+                column_entry entry{};
+                entry.name_hash     = field_info.field_name_hash;
+                entry.blocks_offset = out.size() - file_begin;
+                entry.block_count   = block_count;
+                entry.name_length   = uint16_t(std::strlen(field_info.field_name));
+                entry.kind          = uint8_t(traits::kind);
+                entry.width         = traits::width;
+                std::memcpy(out.data() + directory + column++ * sizeof(column_entry), &entry, sizeof(entry));
+
+                size_t blocks = out.size();
+                out.resize(blocks + block_count * sizeof(column_block));
+
+                using value_type = std::conditional_t<traits::is_string, std::string_view, typename traits::storage_type>;
+                std::vector<value_type> values;
+                values.reserve(std::min<size_t>(block_rows, rows.size()));
+                for(uint32_t b = 0; b < block_count; b++)
+                {
+                    auto block_rows_span = rows.subspan(size_t(b) * block_rows, std::min<size_t>(block_rows, rows.size() - size_t(b) * block_rows));
+                    values.clear();
+                    for(const T& row: block_rows_span)
+                        values.push_back(value_type(row.*(field_info.ptr)));
+
+                    column_block block{};
+                    block.offset = out.size() - file_begin;
+                    block.rows   = uint32_t(values.size());
+                    if constexpr(traits::is_string)
+                        column_encode_strings(values, options.compress, out, block);
+                    else
+                        column_encode_numbers(std::span<const value_type>(values), options.compress, out, block);
+                    block.size = uint32_t(out.size() - file_begin - block.offset);
+                    std::memcpy(out.data() + blocks + b * sizeof(column_block), &block, sizeof(block));
+                }
+            });
+    }
+
+    template<class T>
+    inline bool write_columns(const char* path, std::span<const T> rows, const column_options& options = {})
+    {
+        std::vector<char> out;
+        write_columns(rows, out, options);
+
+        FILE* file = fopen(path, "wb");
+        if(file == nullptr)
+            return false;
+        bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+        return fclose(file) == 0 && written;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // the header and directory are checked on open, block positions when a column is read
+    class column_file
+    {
+    public:
+        bool open(const char* path)
+        {
+            if(!file.open(path))
+                return false;
+            return attach(file.view());
+        }
+
+        // a file image already in memory, e.g. from write_columns(rows, buffer); bytes must outlive the reads
+        bool attach(std::string_view bytes)
+        {
+            data = bytes;
+            directory.clear();
+            names.clear();
+            if(data.size() < sizeof(column_file_header))
+                return false;
+            header = column_get_pod<column_file_header>(data.data());
+            if(std::memcmp(header.magic, column_file_magic, sizeof(header.magic)) != 0 || header.block_rows == 0 ||
+               (data.size() - sizeof(header)) / sizeof(column_entry) < header.column_count)
+                return false;
+
+            size_t name_offset = sizeof(header) + header.column_count * sizeof(column_entry);
+            for(uint32_t i = 0; i < header.column_count; i++)
+            {
+                column_entry entry = column_get_pod<column_entry>(data.data() + sizeof(header) + i * sizeof(column_entry));
+                if(entry.block_count != block_count() || entry.blocks_offset > data.size() ||
+                   (data.size() - entry.blocks_offset) / sizeof(column_block) < entry.block_count || name_offset + entry.name_length > data.size())
+                    return false;
+                directory.push_back(entry);
+                names.push_back(data.substr(name_offset, entry.name_length));
+                name_offset += entry.name_length;
+            }
+            return true;
+        }
+
+        uint64_t row_count() const { return header.row_count; }
+        uint32_t block_rows() const { return header.block_rows; }
+        uint32_t block_count() const { return uint32_t((header.row_count + header.block_rows - 1) / header.block_rows); }
+
+        std::span<const column_entry>     columns() const { return directory; }
+        std::span<const std::string_view> column_names() const { return names; }
+
+        const column_entry* find(uint64_t name_hash) const
+        {
+            auto it = std::find_if(directory.begin(), directory.end(), [name_hash](const column_entry& entry) { return entry.name_hash == name_hash; });
+            return it == directory.end() ? nullptr : &*it;
+        }
+
+        column_block block(const column_entry& entry, uint32_t index) const
+        {
+            return column_get_pod<column_block>(data.data() + entry.blocks_offset + index * sizeof(column_block));
+        }
+
+        // empty if the block points outside the file
+        std::string_view block_bytes(const column_block& block) const
+        {
+            if(block.offset > data.size() || block.size > data.size() - block.offset)
+                return {};
+            return data.substr(block.offset, block.size);
+        }
+
+    private:
+        mapped_file                   file;
+        std::string_view              data;
+        column_file_header            header{};
+        std::vector<column_entry>     directory;
+        std::vector<std::string_view> names;
+    };
+
+    // blocks whose [min, max] misses [min, max] of the column are skipped; rows of a kept block are not filtered
+    struct column_range
+    {
+        uint64_t name_hash;
+        double   min;
+        double   max;
+    };
+
+    // make_column_range<&Trade::price>(100, 200)
+    template<auto Field>
+    constexpr column_range make_column_range(double min, double max)
+    {
+        constexpr uint64_t name_hash = column_name_hash<typename member_ptr_traits<decltype(Field)>::class_type, Field>();
+        return column_range{name_hash, min, max};
+    }
+
+    template<class FieldType, class T, class Setter>
+    inline bool column_decode_block(std::string_view bytes, const column_block& block, Setter&& set)
+    {
+        using traits       = column_traits<FieldType>;
+        using storage_type = typename traits::storage_type;
+
+        const char* p   = bytes.data();
+        const char* end = bytes.data() + bytes.size();
+        if constexpr(traits::is_string)
+        {
+            auto read_string = [&p, end](std::string_view& str)
+            {
+                uint64_t length = 0;
+                if(!column_get_varint(p, end, length) || length > uint64_t(end - p))
+                    return false;
+                str = std::string_view(p, size_t(length));
+                p += length;
+                return true;
+            };
+
+            std::string_view str;
+            if(block.encoding == uint8_t(column_encoding::plain))
+            {
+                for(uint32_t i = 0; i < block.rows; i++)
+                {
+                    if(!read_string(str))
+                        return false;
+                    set(i, str);
+                }
+                return true;
+            }
+            if(block.encoding != uint8_t(column_encoding::dictionary))
+                return false;
+
+            uint64_t count = 0;
+            if(!column_get_varint(p, end, count) || count > uint64_t(end - p))
+                return false;
+            std::vector<std::string_view> dictionary(static_cast<size_t>(count));
+            for(auto& value: dictionary)
+            {
+                if(!read_string(value))
+                    return false;
+            }
+            for(uint32_t i = 0; i < block.rows; i++)
+            {
+                uint64_t index = 0;
+                if(!column_get_varint(p, end, index) || index >= count)
+                    return false;
+                set(i, dictionary[size_t(index)]);
+            }
+            return true;
+        }
+        else
+        {
+            if(block.encoding == uint8_t(column_encoding::plain))
+            {
+                if(bytes.size() != size_t(block.rows) * sizeof(storage_type))
+                    return false;
+                for(uint32_t i = 0; i < block.rows; i++)
+                    set(i, column_get_pod<storage_type>(p + i * sizeof(storage_type)));
+                return true;
+            }
+            if constexpr(std::is_integral_v<storage_type>)
+            {
+                if(block.encoding != uint8_t(column_encoding::delta))
+                    return false;
+                uint64_t previous = 0;
+                for(uint32_t i = 0; i < block.rows; i++)
+                {
+                    uint64_t zigzag = 0;
+                    if(!column_get_varint(p, end, zigzag))
+                        return false;
+                    previous += (zigzag >> 1) ^ (0 - (zigzag & 1));
+                    set(i, storage_type(previous));
+                }
+                return true;
+            }
+            return false;
+        }
+    }
+
+    // appends one row per row of every kept block, only the Fields columns are read and written; out is left as it was on false
+    // std::vector<Trade> trades;
+    // read_columns<Trade, &Trade::time, &Trade::price>(file, trades, {{make_column_range<&Trade::time>(t0, t1)}});
+    template<class T, auto... Fields>
+    inline bool read_columns(const column_file& file, std::vector<T>& out, std::span<const column_range> ranges = {})
+    {
+        std::vector<uint8_t> keep(file.block_count(), 1);
+        for(const auto& range: ranges)
+        {
+            const column_entry* entry = file.find(range.name_hash);
+            if(entry == nullptr || entry->kind == uint8_t(column_kind::string))
+                return false;
+            for(uint32_t b = 0; b < entry->block_count; b++)
+            {
+                column_block block = file.block(*entry, b);
+                if(block.max < range.min || block.min > range.max)
+                    keep[b] = 0;
+            }
+        }
+
+        const size_t base = out.size();
+        size_t       rows = 0;
+        for(uint32_t b = 0; b < file.block_count(); b++)
+        {
+            if(keep[b])
+                rows += std::min<uint64_t>(file.block_rows(), file.row_count() - uint64_t(b) * file.block_rows());
+        }
+        out.resize(base + rows);
+
+        auto read_column = [&file, &out, &keep, base]<auto Field>() -> bool
+        {
+            using field_type = std::remove_cvref_t<decltype(std::declval<T&>().*Field)>;
+            using traits     = column_traits<field_type>;
+
+            constexpr uint64_t  name_hash = column_name_hash<T, Field>();
+            const column_entry* entry     = file.find(name_hash);
+            if(entry == nullptr || entry->kind != uint8_t(traits::kind) || entry->width != traits::width)
+                return false;
+
+            size_t row = base;
+            for(uint32_t b = 0; b < entry->block_count; b++)
+            {
+                if(!keep[b])
+                    continue;
+                column_block     block = file.block(*entry, b);
+                std::string_view bytes = file.block_bytes(block);
+                if(block.rows != std::min<uint64_t>(file.block_rows(), file.row_count() - uint64_t(b) * file.block_rows()) ||
+                   (bytes.empty() && block.size != 0))
+                    return false;
+                bool decoded = column_decode_block<field_type, T>(bytes, block,
+                                                                  [&out, row](uint32_t i, const auto& value)
+                                                                  {
+                                                                      if constexpr(traits::is_string)
+                                                                          out[row + i].*Field = value;
+                                                                      else
+                                                                          out[row + i].*Field = field_type(value);
+                                                                  });
+                if(!decoded)
+                    return false;
+                row += block.rows;
+            }
+            return true;
+        };
+        if((read_column.template operator()<Fields>() && ...))
+            return true;
+        out.resize(base);
+        return false;
+    }
+
+    // the mapping is gone on return, string_view members would point into it: read those through a column_file kept open
+    template<class T, auto... Fields>
+    inline bool read_columns(const char* path, std::vector<T>& out, std::span<const column_range> ranges = {})
+    {
+        static_assert((!std::is_same_v<std::remove_cvref_t<decltype(std::declval<T&>().*Fields)>, std::string_view> && ...),
+                      "std::string_view columns point into the file, open a column_file and pass it to read_columns instead");
+        column_file file;
+        return file.open(path) && read_columns<T, Fields...>(file, out, ranges);
+    }
+} // namespace static_reflection_v2
+
+#endif /* COLUMNSTORE_H */
@@ -0,0 +1,332 @@
+#ifndef CSVTOSTRUCT_H
+#define CSVTOSTRUCT_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "MappedFile.h"
+#include "StaticEnum.h"
+#include "StaticReflectionV2.h"
+#include "StringPool.h"
+
+namespace static_reflection_v2
+{
+    struct csv_options
+    {
+        char   delimiter = ','; // '\t' for TSV
+        size_t threads   = 1;   // > 1 splits the rows at line breaks, so quoted cells must not hold one
+    };
+
+    // first delimiter, '\n' or '\r' in [p, end), end if none; 32 or 16 bytes per compare
+    inline const char* csv_find_special(const char* p, const char* end, char delimiter)
+    {
+#if defined(__AVX2__)
+        const __m256i delimiter_lane = _mm256_set1_epi8(delimiter);
+        const __m256i newline_lane   = _mm256_set1_epi8('\n');
+        const __m256i return_lane    = _mm256_set1_epi8('\r');
+        for(; end - p >= 32; p += 32)
+        {
+            __m256i  x    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i  hit  = _mm256_or_si256(_mm256_cmpeq_epi8(x, delimiter_lane), _mm256_or_si256(_mm256_cmpeq_epi8(x, newline_lane), _mm256_cmpeq_epi8(x, return_lane)));
+            uint32_t mask = uint32_t(_mm256_movemask_epi8(hit));
+            if(mask != 0)
+                return p + std::countr_zero(mask);
+        }
+#elif defined(__SSE2__)
+        const __m128i delimiter_lane = _mm_set1_epi8(delimiter);
+        const __m128i newline_lane   = _mm_set1_epi8('\n');
+        const __m128i return_lane    = _mm_set1_epi8('\r');
+        for(; end - p >= 16; p += 16)
+        {
+            __m128i  x    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i  hit  = _mm_or_si128(_mm_cmpeq_epi8(x, delimiter_lane), _mm_or_si128(_mm_cmpeq_epi8(x, newline_lane), _mm_cmpeq_epi8(x, return_lane)));
+            uint32_t mask = uint32_t(_mm_movemask_epi8(hit));
+            if(mask != 0)
+                return p + std::countr_zero(mask);
+        }
+#endif
+        for(; p < end; p++)
+        {
+            if(*p == delimiter || *p == '\n' || *p == '\r')
+                return p;
+        }
+        return end;
+    }
+
+    template<class FieldType>
+    inline bool csv_to_field(std::string_view cell, FieldType& field)
+    {
+        static_assert(!std::is_same_v<FieldType, std::string_view>,
+                      "a std::string_view member would point into the text or the reader's buffer, make it std::string or META_MEMBER_INTERN");
+
+        if constexpr(std::is_same_v<FieldType, bool>)
+        {
+            if(cell == "1" || cell == "true" || cell == "TRUE")
+                field = true;
+            else if(cell == "0" || cell == "false" || cell == "FALSE")
+                field = false;
+            else
+                return false;
+            return true;
+        }
+        else if constexpr(std::is_enum_v<FieldType>)
+        {
+            if constexpr(have_enum_meta_info<FieldType>::value)
+            {
+                if(enum_from_string(cell, field))
+                    return true;
+            }
+            std::underlying_type_t<FieldType> value{};
+            if(!csv_to_field(cell, value))
+                return false;
+            field = FieldType(value);
+            return true;
+        }
+        else if constexpr(std::is_arithmetic_v<FieldType>)
+        {
+            // from_chars takes no '+'
+            if(cell.size() > 1 && cell[0] == '+')
+                cell.remove_prefix(1);
+            auto [ptr, ec] = std::from_chars(cell.data(), cell.data() + cell.size(), field);
+            return ec == std::errc() && ptr == cell.data() + cell.size();
+        }
+        else if constexpr(std::is_assignable_v<FieldType&, std::string_view>)
+        {
+            field = cell;
+            return true;
+        }
+        else
+        {
+            // nested structs and containers have no CSV form, a column mapped to one is an error rather than dropped
+            return false;
+        }
+    }
+
+    // cells of one line at a time, RFC 4180 quoting
+    struct csv_reader
+    {
+        char        delimiter;
+        std::string unquoted; // a quoted cell with "" in it is copied here
+
+        // false on a quote that is not closed or is followed by something else than a delimiter or line end
+        bool next_cell(const char*& p, const char* end, std::string_view& cell)
+        {
+            if(p == end || *p != '"')
+            {
+                const char* cell_end = csv_find_special(p, end, delimiter);
+                cell                 = std::string_view(p, size_t(cell_end - p));
+                p                    = cell_end;
+                return true;
+            }
+
+            const char* begin = ++p;
+            const char* quote = static_cast<const char*>(std::memchr(p, '"', size_t(end - p)));
+            if(quote == nullptr)
+                return false;
+            if(quote + 1 == end || quote[1] != '"')
+            {
+                cell = std::string_view(begin, size_t(quote - begin));
+                p    = quote + 1;
+                return p == end || *p == delimiter || *p == '\n' || *p == '\r';
+            }
+
+            unquoted.clear();
+            while(quote != nullptr && quote + 1 < end && quote[1] == '"')
+            {
+                unquoted.append(p, quote + 1);
+                p     = quote + 2;
+                quote = static_cast<const char*>(std::memchr(p, '"', size_t(end - p)));
+            }
+            if(quote == nullptr)
+                return false;
+            unquoted.append(p, quote);
+            cell = unquoted;
+            p    = quote + 1;
+            return p == end || *p == delimiter || *p == '\n' || *p == '\r';
+        }
+
+        // past the delimiter: true, past the line end: false
+        bool next_in_row(const char*& p, const char* end) const
+        {
+            if(p < end && *p == delimiter)
+            {
+                p++;
+                return true;
+            }
+            if(p < end && *p == '\r')
+                p++;
+            if(p < end && *p == '\n')
+                p++;
+            return false;
+        }
+    };
+
+    // one parser per member of T, in member_info_tuple order; a group writes every bind
+    template<class T>
+    struct csv_columns
+    {
+        using setter = bool (*)(T& value, std::string_view cell);
+
+        static constexpr size_t size = getClassMemberSize<T>();
+
+        static constexpr auto setters = []<size_t... I>(std::index_sequence<I...>)
+        {
+            return std::array<setter, size>{[](T& value, std::string_view cell) -> bool
+                                            {
+                                                return InvokeFieldFn(value, std::get<I>(getClassMetaInfo<T>().member_info_tuple),
+                                                                     [cell](const auto&, auto& field, auto&&... extra)
+                                                                     {
+                                                                         if constexpr(is_intern_field<decltype(extra)...>)
+                                                                         {
+                                                                             intern_to_field(cell, field);
+                                                                             return true;
+                                                                         }
+                                                                         else
+                                                                         {
+                                                                             return csv_to_field(cell, field);
+                                                                         }
+                                                                     });
+                                            }...};
+        }(std::make_index_sequence<size>{});
+
+        static setter find(size_t field_hash)
+        {
+            constexpr auto meta_class = getClassMetaInfo<T>();
+            setter         found      = nullptr;
+            find_if_tuple_index(meta_class.member_info_tuple,
+                                [field_hash, &found](const auto& field_info, size_t index) -> bool
+                                {
+                                    if(field_info.field_name_hash != field_hash)
+                                        return false;
+                                    found = setters[index];
+                                    return true;
+                                });
+            return found;
+        }
+    };
+
+    template<class T>
+    inline bool csv_rows_to_vector(const char* p, const char* end, const std::vector<typename csv_columns<T>::setter>& columns, char delimiter,
+                                   std::vector<T>& out)
+    {
+        csv_reader reader{delimiter, {}};
+        while(p < end)
+        {
+            if(*p == '\n' || *p == '\r')
+            {
+                p++;
+                continue;
+            }
+
+            T&     row    = out.emplace_back();
+            size_t column = 0;
+            do
+            {
+                std::string_view cell;
+                if(!reader.next_cell(p, end, cell))
+                    return false;
+                // an empty cell keeps the default, extra cells are ignored
+                if(column < columns.size() && columns[column] != nullptr && !cell.empty() && !columns[column](row, cell))
+                    return false;
+                column++;
+            } while(reader.next_in_row(p, end));
+        }
+        return true;
+    }
+
+    // the first line names the columns, matched to members by name hash once; columns without a member are skipped
+    // rows are appended to out if every line parses; false on a malformed line or a cell its member can not parse, out unchanged
+    template<class T>
+    inline bool csv_to_vector(std::string_view text, std::vector<T>& out, const csv_options& options = {})
+    {
+        // a UTF-8 byte order mark is not part of the first column name
+        if(text.starts_with("\xEF\xBB\xBF"))
+            text.remove_prefix(3);
+        const char* p   = text.data();
+        const char* end = text.data() + text.size();
+
+        std::vector<typename csv_columns<T>::setter> columns;
+        csv_reader                                   header{options.delimiter, {}};
+        do
+        {
+            std::string_view name;
+            if(!header.next_cell(p, end, name))
+                return false;
+            columns.push_back(csv_columns<T>::find(make_string_hash<T>(name)));
+        } while(header.next_in_row(p, end));
+
+        size_t threads = std::max<size_t>(1, std::min(options.threads, size_t(end - p) / 4096));
+        if(threads == 1)
+        {
+            size_t old_size = out.size();
+            if(csv_rows_to_vector(p, end, columns, options.delimiter, out))
+                return true;
+            out.erase(out.begin() + ptrdiff_t(old_size), out.end());
+            return false;
+        }
+
+        // chunk boundaries move forward to the next line start
+        std::vector<const char*> bounds{p};
+        for(size_t i = 1; i < threads; i++)
+        {
+            const char* bound = std::max(bounds.back(), p + (end - p) * ptrdiff_t(i) / ptrdiff_t(threads));
+            const char* line  = static_cast<const char*>(std::memchr(bound, '\n', size_t(end - bound)));
+            bounds.push_back(line == nullptr ? end : line + 1);
+        }
+        bounds.push_back(end);
+
+        std::vector<std::vector<T>> parts(threads);
+        std::vector<char>           results(threads);
+        {
+            // the workers intern into the pool of the calling thread
+            string_pool&              pool = current_string_pool();
+            std::vector<std::jthread> workers;
+            for(size_t i = 0; i < threads; i++)
+            {
+                workers.emplace_back(
+                    [&, i]()
+                    {
+                        string_pool_scope scope(pool);
+                        results[i] = csv_rows_to_vector(bounds[i], bounds[i + 1], columns, options.delimiter, parts[i]);
+                    });
+            }
+        }
+
+        if(!std::all_of(results.begin(), results.end(), [](char result) { return result != 0; }))
+            return false;
+
+        size_t rows = 0;
+        for(const auto& part: parts)
+            rows += part.size();
+        out.reserve(out.size() + rows);
+        for(auto& part: parts)
+            std::move(part.begin(), part.end(), std::back_inserter(out));
+        return true;
+    }
+
+    // the file is mapped instead of read where mmap exists
+    template<class T>
+    inline bool csv_file_to_vector(const char* path, std::vector<T>& out, const csv_options& options = {})
+    {
+        mapped_file file;
+        if(!file.open(path))
+            return false;
+        file.advise_sequential();
+        return csv_to_vector(file.view(), out, options);
+    }
+} // namespace static_reflection_v2
+
+#endif /* CSVTOSTRUCT_H */
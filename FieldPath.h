@@ -0,0 +1,237 @@
+#ifndef FIELDPATH_H
+#define FIELDPATH_H
+
+#include <array>
+#include <charconv>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "PerfectHash.h"
+#include "StaticEnum.h"
+#include "StaticHash.h"
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    // segments always use the default hash policy, whatever policy each nested class has
+    // so a path is hashed without knowing the classes it walks through
+    constexpr size_t combine_path_hash(size_t parent_hash, size_t field_hash)
+    {
+        return parent_hash == 0 ? field_hash : size_t(hash::hash64shift(parent_hash ^ (field_hash + 0x9E3779B97F4A7C15ULL + (parent_hash << 6) + (parent_hash >> 2))));
+    }
+
+    constexpr size_t make_path_hash(std::string_view path)
+    {
+        size_t path_hash = 0;
+        while(true)
+        {
+            size_t pos = path.find('.');
+            path_hash  = combine_path_hash(path_hash, make_string_hash(path.substr(0, pos)));
+            if(pos == std::string_view::npos)
+                return path_hash;
+            path = path.substr(pos + 1);
+        }
+    }
+
+    template<class T>
+    constexpr auto make_field_path_tuple();
+
+    // every path is a tuple of the FieldInfo chain from T down to the leaf
+    // a name bound to several members has no single leaf and is left out
+    template<class FieldInfo>
+    constexpr auto make_field_path_of(const FieldInfo& field_info)
+    {
+        if constexpr(is_member_func<FieldInfo>() || is_member_ptr_group<FieldInfo>())
+        {
+            return std::tuple<>{};
+        }
+        else
+        {
+            using member_type = typename member_ptr_traits<decltype(field_info.ptr)>::member_type;
+            auto self_path    = std::make_tuple(std::make_tuple(field_info));
+            if constexpr(have_meta_info<member_type>::value)
+            {
+                auto sub_path = std::apply([&field_info](const auto&... path) constexpr
+                                           { return std::make_tuple(std::tuple_cat(std::make_tuple(field_info), path)...); },
+                                           make_field_path_tuple<member_type>());
+                return std::tuple_cat(self_path, sub_path);
+            }
+            else
+            {
+                return self_path;
+            }
+        }
+    }
+
+    template<class T>
+    constexpr auto make_field_path_tuple()
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        return std::apply([](const auto&... field_info) constexpr { return std::tuple_cat(make_field_path_of(field_info)...); },
+                          meta_class.member_info_tuple);
+    }
+
+    template<class Path>
+    constexpr size_t get_path_hash(const Path& path)
+    {
+        return std::apply([](const auto&... field_info) constexpr
+                          {
+                              size_t path_hash = 0;
+                              ((path_hash = combine_path_hash(path_hash, make_string_hash(field_info.field_name))), ...);
+                              return path_hash;
+                          },
+                          path);
+    }
+
+    template<class Path>
+    constexpr bool is_path_match(const Path& path, std::string_view path_name)
+    {
+        return std::apply([path_name](const auto&... field_info) constexpr mutable
+                          {
+                              bool match = true;
+                              (
+                                  [&]()
+                                  {
+                                      size_t pos = path_name.find('.');
+                                      match      = match && path_name.substr(0, pos) == field_info.field_name;
+                                      path_name  = pos == std::string_view::npos ? std::string_view{} : path_name.substr(pos + 1);
+                                  }(),
+                                  ...);
+                              return match && path_name.empty();
+                          },
+                          path);
+    }
+
+    template<size_t I = 0, class Value, class Path>
+    constexpr auto& resolve_path(Value& value, const Path& path)
+    {
+        auto& member = value.*(std::get<I>(path).ptr);
+        if constexpr(I + 1 == std::tuple_size_v<Path>)
+            return member;
+        else
+            return resolve_path<I + 1>(member, path);
+    }
+
+    // all nested member paths of T flattened into one perfect hash table
+    // each entry resolves through its member pointer chain, which folds to base + constant offset
+    template<class T>
+    struct FieldPathTable
+    {
+        static constexpr auto   path_tuple = make_field_path_tuple<T>();
+        static constexpr size_t size       = std::tuple_size_v<decltype(path_tuple)>;
+
+        static constexpr auto path_hash_table = []() constexpr
+        {
+            return std::apply([](const auto&... path) constexpr { return make_perfect_hash(std::array<size_t, size>{get_path_hash(path)...}); },
+                              path_tuple);
+        }();
+
+        template<size_t I, class Value, class Fn>
+        static bool visit_path(Value& value, std::string_view path_name, Fn& fn)
+        {
+            constexpr auto path = std::get<I>(path_tuple);
+            if(!is_path_match(path, path_name))
+                return false;
+
+            constexpr auto field_info = std::get<std::tuple_size_v<decltype(path)> - 1>(path);
+            auto&          field      = resolve_path(value, path);
+            if constexpr(is_member_ptr_tag<decltype(field_info)>())
+                return fn(field_info, field, field_info.tag);
+            else if constexpr(is_member_ptr_func<decltype(field_info)>())
+                return fn(field_info, field, field_info.func);
+            else
+                return fn(field_info, field);
+        }
+
+        template<class Value, class Fn>
+        static constexpr auto make_jump_table()
+        {
+            return []<size_t... I>(std::index_sequence<I...>) constexpr
+            {
+                return std::array<bool (*)(Value&, std::string_view, Fn&), size>{&visit_path<I, Value, Fn>...};
+            }
+            (std::make_index_sequence<size>{});
+        }
+    };
+
+    // find_by_path(config, "stOnCastOut.iOutCnt", [](auto field_info, auto& field, auto&&...) { ...; return true; });
+    template<typename T, typename Fn>
+    inline bool find_by_path(T&& value, std::string_view path_name, Fn&& fn)
+    {
+        using table = FieldPathTable<std::decay_t<T>>;
+        using Value = std::remove_reference_t<T>;
+
+        size_t index = table::path_hash_table.find(make_path_hash(path_name));
+        if(index == table::path_hash_table.npos)
+            return false;
+
+        static constexpr auto jump_table = table::template make_jump_table<Value, std::remove_reference_t<Fn>>();
+        return jump_table[index](value, path_name, fn);
+    }
+
+    // nullptr if the path does not exist or the leaf is not a Field
+    template<typename Field, typename T>
+    inline auto get_by_path(T&& value, std::string_view path_name)
+    {
+        using FieldPtr = std::conditional_t<std::is_const_v<std::remove_reference_t<T>>, const Field*, Field*>;
+        FieldPtr result = nullptr;
+        find_by_path(value,
+                     path_name,
+                     [&result](const auto&, auto& field, auto&&...)
+                     {
+                         if constexpr(std::is_same_v<std::remove_cv_t<std::remove_reference_t<decltype(field)>>, Field>)
+                             result = &field;
+                         return true;
+                     });
+        return result;
+    }
+
+    template<class Field>
+    inline bool string_to_field(std::string_view str, Field& field)
+    {
+        if constexpr(std::is_same_v<Field, bool>)
+        {
+            if(str != "true" && str != "false" && str != "1" && str != "0")
+                return false;
+            field = str == "true" || str == "1";
+            return true;
+        }
+        else if constexpr(std::is_arithmetic_v<Field>)
+        {
+            auto result = std::from_chars(str.data(), str.data() + str.size(), field);
+            return result.ec == std::errc() && result.ptr == str.data() + str.size();
+        }
+        else if constexpr(std::is_enum_v<Field> && have_enum_meta_info<Field>::value)
+        {
+            return enum_from_string(str, field);
+        }
+        else if constexpr(std::is_assignable_v<Field&, std::string_view>)
+        {
+            field = str;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // --set c.stOnCastOut.iOutCnt=1
+    template<typename T>
+    inline bool set_by_path(T& value, std::string_view path_name, std::string_view str)
+    {
+        bool result = false;
+        find_by_path(value,
+                     path_name,
+                     [str, &result](const auto&, auto& field, auto&&...)
+                     {
+                         result = string_to_field(str, field);
+                         return true;
+                     });
+        return result;
+    }
+} // namespace static_reflection_v2
+
+#endif /* FIELDPATH_H */
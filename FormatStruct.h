@@ -0,0 +1,248 @@
+#ifndef FORMATSTRUCT_H
+#define FORMATSTRUCT_H
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+#include "StaticEnum.h"
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    struct format_options
+    {
+        size_t max_elements = 16; // array elements written, the rest counted as ...(+n)
+        size_t max_depth    = 4;  // nested structs below this are written as {...}
+    };
+
+    // a fixed line that keeps what fits and drops the rest, never allocates
+    // line_buffer<256> line;
+    // format_to(line, value);
+    // fwrite(line.view().data(), 1, line.view().size(), log_file);
+    template<size_t Capacity>
+    class line_buffer
+    {
+    public:
+        void append(const char* data, size_t size)
+        {
+            size_t room = Capacity - length;
+            if(size > room)
+            {
+                size          = room;
+                was_truncated = true;
+            }
+            std::memcpy(buffer + length, data, size);
+            length += size;
+        }
+
+        void clear()
+        {
+            length        = 0;
+            was_truncated = false;
+        }
+
+        std::string_view view() const { return std::string_view(buffer, length); }
+        bool             truncated() const { return was_truncated; }
+
+    private:
+        char   buffer[Capacity];
+        size_t length        = 0;
+        bool   was_truncated = false;
+    };
+
+    // any buffer with append(data, size), a ring buffer included, or a container of char like std::string / std::vector<char>
+    template<class Buffer>
+    inline void format_append(Buffer& out, std::string_view str)
+    {
+        if constexpr(requires { out.append(str.data(), str.size()); })
+            out.append(str.data(), str.size());
+        else
+            out.insert(out.end(), str.begin(), str.end());
+    }
+
+    // "name=" of every member of T in member_info_tuple order, built at compile time
+    template<class T>
+    struct FormatNameTable
+    {
+        static constexpr size_t size = getClassMemberSize<T>();
+
+        static constexpr size_t blob_size = []() constexpr
+        {
+            return std::apply([](const auto&... field_info) constexpr { return (size_t(0) + ... + (std::string_view(field_info.field_name).size() + 1)); },
+                              getClassMetaInfo<T>().member_info_tuple);
+        }();
+
+        // offsets[i] .. offsets[i + 1] is "name=" of member i
+        static constexpr std::array<size_t, size + 1> offsets = []() constexpr
+        {
+            std::array<size_t, size + 1> table{};
+            size_t                       index = 0;
+            std::apply([&table, &index](const auto&... field_info) constexpr
+                       { ((table[index + 1] = table[index] + std::string_view(field_info.field_name).size() + 1, index++), ...); },
+                       getClassMetaInfo<T>().member_info_tuple);
+            return table;
+        }();
+
+        static constexpr std::array<char, blob_size> blob = []() constexpr
+        {
+            std::array<char, blob_size> chars{};
+            size_t                      pos    = 0;
+            auto                        append = [&chars, &pos](std::string_view name) constexpr
+            {
+                for(char c: name)
+                    chars[pos++] = c;
+                chars[pos++] = '=';
+            };
+            std::apply([&append](const auto&... field_info) constexpr { (append(field_info.field_name), ...); }, getClassMetaInfo<T>().member_info_tuple);
+            return chars;
+        }();
+
+        static std::string_view name(size_t index) { return std::string_view(blob.data() + offsets[index], offsets[index + 1] - offsets[index]); }
+    };
+
+    template<class Buffer, class T>
+    inline void format_struct(Buffer& out, const T& value, const format_options& options, size_t depth);
+
+    template<class FieldType>
+    inline constexpr bool is_format_string = !std::is_pointer_v<FieldType> && std::is_convertible_v<const FieldType&, std::string_view>;
+
+    template<class FieldType>
+    inline constexpr bool is_format_range = requires(const FieldType& f) {
+        std::begin(f);
+        std::end(f);
+    };
+
+    template<class Buffer, class FieldType>
+    inline void format_value(Buffer& out, const FieldType& field, const format_options& options, size_t depth)
+    {
+        if constexpr(have_meta_info<FieldType>::value)
+        {
+            format_struct(out, field, options, depth + 1);
+        }
+        else if constexpr(std::is_same_v<FieldType, bool>)
+        {
+            format_append(out, field ? "true" : "false");
+        }
+        else if constexpr(std::is_arithmetic_v<FieldType>)
+        {
+            char buffer[64];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), field);
+            format_append(out, std::string_view(buffer, size_t(result.ptr - buffer)));
+        }
+        else if constexpr(std::is_enum_v<FieldType>)
+        {
+            if constexpr(have_enum_meta_info<FieldType>::value)
+            {
+                if(const char* name = enum_to_string(field))
+                {
+                    format_append(out, name);
+                    return;
+                }
+            }
+            format_value(out, std::underlying_type_t<FieldType>(field), options, depth);
+        }
+        else if constexpr(std::is_array_v<FieldType> && std::is_same_v<std::remove_extent_t<FieldType>, char>)
+        {
+            // a fixed char array is a C string, up to its '\0'
+            format_append(out, "\"");
+            format_append(out, std::string_view(field, strnlen(field, std::extent_v<FieldType>)));
+            format_append(out, "\"");
+        }
+        else if constexpr(is_format_string<FieldType>)
+        {
+            format_append(out, "\"");
+            format_append(out, std::string_view(field));
+            format_append(out, "\"");
+        }
+        else if constexpr(is_format_range<FieldType>)
+        {
+            format_append(out, "[");
+            size_t count = 0;
+            for(const auto& element: field)
+            {
+                if(count == options.max_elements)
+                    break;
+                if(count++ != 0)
+                    format_append(out, ", ");
+                format_value(out, element, options, depth);
+            }
+            size_t total = size_t(std::distance(std::begin(field), std::end(field)));
+            if(total > count)
+            {
+                char buffer[32];
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), total - count);
+                format_append(out, count != 0 ? ", ...(+" : "...(+");
+                format_append(out, std::string_view(buffer, size_t(result.ptr - buffer)));
+                format_append(out, ")");
+            }
+            format_append(out, "]");
+        }
+        else
+        {
+            format_append(out, "?");
+        }
+    }
+
+    template<class Buffer, class T>
+    inline void format_struct(Buffer& out, const T& value, const format_options& options, size_t depth)
+    {
+        if(depth > options.max_depth)
+        {
+            format_append(out, "{...}");
+            return;
+        }
+
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        size_t         index      = 0;
+        bool           first      = true;
+        format_append(out, "{");
+        for_each_tuple(meta_class.member_info_tuple,
+                       [&](const auto& field_info)
+                       {
+                           if constexpr(!is_member_func<decltype(field_info)>())
+                           {
+                               if(!first)
+                                   format_append(out, ", ");
+                               first = false;
+                               format_append(out, FormatNameTable<T>::name(index));
+                               if constexpr(is_member_ptr_group<decltype(field_info)>())
+                               {
+                                   // every member bound to the name
+                                   bool first_bind = true;
+                                   format_append(out, "(");
+                                   for_each_member_bind(field_info,
+                                                        [&](const auto& bind_info)
+                                                        {
+                                                            if(!first_bind)
+                                                                format_append(out, ", ");
+                                                            first_bind = false;
+                                                            format_value(out, value.*(bind_info.ptr), options, depth);
+                                                        });
+                                   format_append(out, ")");
+                               }
+                               else
+                               {
+                                   format_value(out, value.*(field_info.ptr), options, depth);
+                               }
+                           }
+                           index++;
+                       });
+        format_append(out, "}");
+    }
+
+    // {name=value, ...} of a reflected value appended to out, no allocation besides what out does itself
+    // line_buffer<512> line;
+    // format_to(line, cast, {.max_elements = 4});  // {castTime=10, ..., onStart={iOutCnt=2, aiOutID=[1, 2, 0, 0, ...(+96)]}, ...}
+    template<class Buffer, class T>
+    inline void format_to(Buffer& out, const T& value, const format_options& options = {})
+    {
+        format_struct(out, value, options, 0);
+    }
+} // namespace static_reflection_v2
+
+#endif /* FORMATSTRUCT_H */
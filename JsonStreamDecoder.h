@@ -0,0 +1,663 @@
+#ifndef JSONSTREAMDECODER_H
+#define JSONSTREAMDECODER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "StaticEnum.h"
+#include "StaticReflectionV2.h"
+#include "StringPool.h"
+
+namespace static_reflection_v2
+{
+    struct json_sink;
+
+    // what a decoded value can be written into, one table per field type
+    // on_string / on_number return false for a value the field cannot hold, which stops the parse
+    // field appends a sink per member the key names, every bind of a META_MEMBER_BIND group
+    struct json_sink_vtable
+    {
+        bool (*on_string)(void* target, std::string_view str);
+        bool (*on_number)(void* target, std::string_view str);
+        void (*on_bool)(void* target, bool value);
+        bool (*begin_object)(void* target);
+        void (*field)(void* target, std::string_view key, std::vector<json_sink>& sinks);
+        bool (*begin_array)(void* target);
+        json_sink (*element)(void* target, size_t index);
+    };
+
+    // a type-erased field reference, an empty sink skips whatever value is sent to it
+    struct json_sink
+    {
+        void*                   target = nullptr;
+        const json_sink_vtable* vtable = nullptr;
+
+        bool      on_string(std::string_view str) const { return vtable == nullptr || vtable->on_string(target, str); }
+        bool      on_number(std::string_view str) const { return vtable == nullptr || vtable->on_number(target, str); }
+        void      on_bool(bool value) const { if(vtable != nullptr) vtable->on_bool(target, value); }
+        bool      begin_object() const { return vtable != nullptr && vtable->begin_object(target); }
+        void      field(std::string_view key, std::vector<json_sink>& sinks) const { if(vtable != nullptr) vtable->field(target, key, sinks); }
+        bool      begin_array() const { return vtable != nullptr && vtable->begin_array(target); }
+        json_sink element(size_t index) const { return vtable != nullptr ? vtable->element(target, index) : json_sink{}; }
+    };
+
+    // the whole token or nothing, "1-2e" is no 1
+    template<class Number>
+    inline bool json_parse_number(std::string_view str, Number& out)
+    {
+        Number value{};
+        auto   result = std::from_chars(str.data(), str.data() + str.size(), value);
+        if(result.ec != std::errc() || result.ptr != str.data() + str.size())
+            return false;
+        out = value;
+        return true;
+    }
+
+    template<class FieldType>
+    json_sink make_json_sink(FieldType& field);
+
+    // a META_MEMBER_INTERN member: the string goes to the pool, the token buffer is reused
+    inline constexpr json_sink_vtable json_intern_sink_vtable{
+        [](void* target, std::string_view str)
+        {
+            intern_to_field(str, *static_cast<std::string_view*>(target));
+            return true;
+        },
+        [](void*, std::string_view) { return true; },
+        [](void*, bool) {},
+        [](void*) { return false; },
+        [](void*, std::string_view, std::vector<json_sink>&) {},
+        [](void*) { return false; },
+        [](void*, size_t) { return json_sink{}; }};
+
+    template<class FieldType>
+    struct json_sink_ops
+    {
+        static constexpr bool is_array = requires(FieldType& f) {
+            f.clear();
+            f.emplace_back();
+            f.back();
+        };
+
+        static constexpr bool is_char_array = std::is_array_v<FieldType> && std::is_same_v<std::remove_extent_t<FieldType>, char>;
+
+        // a C array or std::array, elements past its extent are skipped
+        static constexpr bool is_fixed_array = !is_char_array && !have_meta_info<FieldType>::value &&
+                                               (std::is_array_v<FieldType> || requires(FieldType& f) {
+                                                   std::tuple_size<FieldType>::value;
+                                                   f[0];
+                                               });
+
+        static FieldType& get(void* target) { return *static_cast<FieldType*>(target); }
+
+        static bool on_string(void* target, std::string_view str)
+        {
+            static_assert(!std::is_same_v<FieldType, std::string_view>,
+                          "a std::string_view member would point into the token buffer, make it std::string or META_MEMBER_INTERN");
+
+            if constexpr(std::is_enum_v<FieldType> && have_enum_meta_info<FieldType>::value)
+            {
+                enum_from_string(str, get(target));
+            }
+            else if constexpr(is_char_array)
+            {
+                // a C string, the '\0' has to fit
+                if(str.size() >= std::extent_v<FieldType>)
+                    return false;
+                std::memcpy(get(target), str.data(), str.size());
+                std::memset(get(target) + str.size(), 0, std::extent_v<FieldType> - str.size());
+            }
+            else if constexpr(!std::is_arithmetic_v<FieldType> && std::is_assignable_v<FieldType&, std::string_view>)
+            {
+                get(target) = str;
+            }
+            return true;
+        }
+
+        static bool on_number(void* target, std::string_view str)
+        {
+            if constexpr(std::is_arithmetic_v<FieldType> && !std::is_same_v<FieldType, bool>)
+            {
+                return json_parse_number(str, get(target));
+            }
+            else if constexpr(std::is_enum_v<FieldType>)
+            {
+                std::underlying_type_t<FieldType> value{};
+                if(!json_parse_number(str, value))
+                    return false;
+                get(target) = FieldType(value);
+            }
+            return true;
+        }
+
+        static void on_bool(void* target, bool value)
+        {
+            if constexpr(std::is_same_v<FieldType, bool>)
+                get(target) = value;
+        }
+
+        static bool begin_object(void*) { return have_meta_info<FieldType>::value; }
+
+        // a name bound to several members decodes into every one of them
+        static void field(void* target, std::string_view key, std::vector<json_sink>& sinks)
+        {
+            if constexpr(have_meta_info<FieldType>::value)
+            {
+                FindInField(get(target), make_string_hash<FieldType>(key),
+                            [&sinks](const auto&, auto& member, auto&&... extra)
+                            {
+                                if constexpr(is_intern_field<decltype(extra)...>)
+                                {
+                                    static_assert(std::is_same_v<std::decay_t<decltype(member)>, std::string_view>,
+                                                  "META_MEMBER_INTERN members are std::string_view into the string pool");
+                                    sinks.push_back(json_sink{&member, &json_intern_sink_vtable});
+                                }
+                                else
+                                {
+                                    sinks.push_back(make_json_sink(member));
+                                }
+                                return true;
+                            });
+            }
+        }
+
+        static bool begin_array(void* target)
+        {
+            if constexpr(is_array)
+                get(target).clear();
+            return is_array || is_fixed_array;
+        }
+
+        static json_sink element(void* target, size_t index)
+        {
+            if constexpr(is_array)
+            {
+                get(target).emplace_back();
+                return make_json_sink(get(target).back());
+            }
+            else if constexpr(is_fixed_array)
+            {
+                if(index < std::size(get(target)))
+                    return make_json_sink(get(target)[index]);
+                return json_sink{};
+            }
+            else
+            {
+                return json_sink{};
+            }
+        }
+
+        static constexpr json_sink_vtable vtable{&on_string, &on_number, &on_bool, &begin_object, &field, &begin_array, &element};
+    };
+
+    template<class FieldType>
+    json_sink make_json_sink(FieldType& field)
+    {
+        return json_sink{&field, &json_sink_ops<FieldType>::vtable};
+    }
+
+    enum class json_stream_status
+    {
+        need_more,
+        done,
+        error
+    };
+
+    // resumable JSON tokenizer: every byte is looked at once, whatever the chunk boundaries are
+    // memory is bounded by max_token_size (one string or number) and max_depth (nesting)
+    class json_stream_parser
+    {
+    public:
+        json_stream_parser(json_sink root, size_t max_token_size, size_t max_depth)
+            : max_token_size(max_token_size)
+            , max_depth(max_depth)
+        {
+            frames.reserve(max_depth);
+            sinks.reserve(max_depth + 1);
+            reset(root);
+        }
+
+        void reset(json_sink root)
+        {
+            frames.clear();
+            sinks.assign(1, root);
+            token.clear();
+            state    = parse_state::value;
+            consumed = 0;
+        }
+
+        json_stream_status feed(std::span<const char> chunk)
+        {
+            for(size_t i = 0; i < chunk.size() && state != parse_state::error;)
+            {
+                if(step(chunk[i]))
+                {
+                    i++;
+                    consumed++;
+                }
+            }
+            return status();
+        }
+
+        // end of input, completes a number at the top level, anything else unfinished is an error
+        json_stream_status finish()
+        {
+            if(state == parse_state::number && frames.empty())
+                step(' ');
+            if(state != parse_state::done)
+                state = parse_state::error;
+            return status();
+        }
+
+        json_stream_status status() const
+        {
+            return state == parse_state::done ? json_stream_status::done : state == parse_state::error ? json_stream_status::error : json_stream_status::need_more;
+        }
+
+        // bytes accepted so far, the position of the bad byte after an error
+        size_t offset() const { return consumed; }
+
+    private:
+        enum class parse_state
+        {
+            value,
+            object_key_or_end,
+            object_key,
+            colon,
+            array_value_or_end,
+            after_value,
+            string,
+            string_escape,
+            string_unicode,
+            number,
+            literal,
+            done,
+            error
+        };
+
+        // sinks[sink_begin, sink_end) get the fields of this object or the elements of this array
+        struct frame
+        {
+            size_t sink_begin;
+            size_t sink_end;
+            size_t count;
+            bool   is_object;
+        };
+
+        static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+        static bool is_json_number(std::string_view str)
+        {
+            size_t pos    = 0;
+            auto   digits = [&str, &pos]()
+            {
+                size_t begin = pos;
+                while(pos < str.size() && str[pos] >= '0' && str[pos] <= '9')
+                    pos++;
+                return pos != begin;
+            };
+
+            if(pos < str.size() && str[pos] == '-')
+                pos++;
+            if(pos < str.size() && str[pos] == '0')
+                pos++;
+            else if(!digits())
+                return false;
+            if(pos < str.size() && str[pos] == '.' && (++pos, !digits()))
+                return false;
+            if(pos < str.size() && (str[pos] == 'e' || str[pos] == 'E'))
+            {
+                if(++pos < str.size() && (str[pos] == '+' || str[pos] == '-'))
+                    pos++;
+                if(!digits())
+                    return false;
+            }
+            return pos == str.size();
+        }
+
+        // the sinks of the value being parsed follow those of the innermost frame
+        size_t pending_begin() const { return frames.empty() ? 0 : frames.back().sink_end; }
+
+        bool fail()
+        {
+            state = parse_state::error;
+            return false;
+        }
+
+        bool append(char c)
+        {
+            if(token.size() >= max_token_size)
+                return fail();
+            token += c;
+            return true;
+        }
+
+        void append_utf8(uint32_t code)
+        {
+            if(code < 0x80)
+            {
+                append(char(code));
+            }
+            else if(code < 0x800)
+            {
+                append(char(0xC0 | (code >> 6)));
+                append(char(0x80 | (code & 0x3F)));
+            }
+            else if(code < 0x10000)
+            {
+                append(char(0xE0 | (code >> 12)));
+                append(char(0x80 | ((code >> 6) & 0x3F)));
+                append(char(0x80 | (code & 0x3F)));
+            }
+            else
+            {
+                append(char(0xF0 | (code >> 18)));
+                append(char(0x80 | ((code >> 12) & 0x3F)));
+                append(char(0x80 | ((code >> 6) & 0x3F)));
+                append(char(0x80 | (code & 0x3F)));
+            }
+        }
+
+        void complete_value()
+        {
+            sinks.resize(pending_begin());
+            state = frames.empty() ? parse_state::done : parse_state::after_value;
+        }
+
+        // the pending sinks that take an object or array become the sinks of the new frame
+        bool open(bool is_object)
+        {
+            if(frames.size() >= max_depth)
+                return fail();
+            size_t begin = pending_begin();
+            size_t end   = begin;
+            for(size_t i = begin; i < sinks.size(); i++)
+            {
+                if(is_object ? sinks[i].begin_object() : sinks[i].begin_array())
+                    sinks[end++] = sinks[i];
+            }
+            sinks.resize(end);
+            frames.push_back(frame{begin, end, 0, is_object});
+            state = is_object ? parse_state::object_key_or_end : parse_state::array_value_or_end;
+            return true;
+        }
+
+        bool close(bool is_object)
+        {
+            if(frames.back().is_object != is_object)
+                return fail();
+            frames.pop_back();
+            complete_value();
+            return true;
+        }
+
+        void begin_field()
+        {
+            const frame& top = frames.back();
+            sinks.resize(top.sink_end);
+            for(size_t i = top.sink_begin; i < top.sink_end; i++)
+                sinks[i].field(token, sinks);
+        }
+
+        void begin_element()
+        {
+            frame& top = frames.back();
+            sinks.resize(top.sink_end);
+            for(size_t i = top.sink_begin; i < top.sink_end; i++)
+            {
+                json_sink element = sinks[i].element(top.count);
+                if(element.vtable != nullptr)
+                    sinks.push_back(element);
+            }
+            top.count++;
+        }
+
+        bool start_literal(const char* text, parse_state next)
+        {
+            literal     = text;
+            literal_pos = 1;
+            state       = next;
+            return true;
+        }
+
+        // false: c ends a number and has to be looked at again in the next state
+        bool step(char c)
+        {
+            switch(state)
+            {
+                case parse_state::value:
+                    if(is_space(c))
+                        return true;
+                    switch(c)
+                    {
+                        case '{':
+                            return open(true);
+                        case '[':
+                            return open(false);
+                        case '"':
+                            token.clear();
+                            is_key = false;
+                            state  = parse_state::string;
+                            return true;
+                        case 't':
+                            return start_literal("true", parse_state::literal);
+                        case 'f':
+                            return start_literal("false", parse_state::literal);
+                        case 'n':
+                            return start_literal("null", parse_state::literal);
+                        default:
+                            if(c != '-' && (c < '0' || c > '9'))
+                                return fail();
+                            token.clear();
+                            state = parse_state::number;
+                            return append(c);
+                    }
+
+                case parse_state::object_key_or_end:
+                case parse_state::object_key:
+                    if(is_space(c))
+                        return true;
+                    if(c == '}' && state == parse_state::object_key_or_end)
+                        return close(true);
+                    if(c != '"')
+                        return fail();
+                    token.clear();
+                    is_key = true;
+                    state  = parse_state::string;
+                    return true;
+
+                case parse_state::colon:
+                    if(is_space(c))
+                        return true;
+                    if(c != ':')
+                        return fail();
+                    begin_field();
+                    state = parse_state::value;
+                    return true;
+
+                case parse_state::array_value_or_end:
+                    if(is_space(c))
+                        return true;
+                    if(c == ']')
+                        return close(false);
+                    begin_element();
+                    state = parse_state::value;
+                    return false;
+
+                case parse_state::after_value:
+                    if(is_space(c))
+                        return true;
+                    if(c == '}' || c == ']')
+                        return close(c == '}');
+                    if(c != ',')
+                        return fail();
+                    if(frames.back().is_object)
+                    {
+                        state = parse_state::object_key;
+                    }
+                    else
+                    {
+                        begin_element();
+                        state = parse_state::value;
+                    }
+                    return true;
+
+                case parse_state::string:
+                    if(c == '"')
+                    {
+                        if(is_key)
+                        {
+                            state = parse_state::colon;
+                        }
+                        else
+                        {
+                            for(size_t i = pending_begin(); i < sinks.size(); i++)
+                            {
+                                if(!sinks[i].on_string(token))
+                                    return fail();
+                            }
+                            complete_value();
+                        }
+                        return true;
+                    }
+                    if(c == '\\')
+                    {
+                        state = parse_state::string_escape;
+                        return true;
+                    }
+                    if(uint8_t(c) < 0x20)
+                        return fail();
+                    return append(c);
+
+                case parse_state::string_escape:
+                    state = parse_state::string;
+                    switch(c)
+                    {
+                        case '"':
+                        case '\\':
+                        case '/':
+                            return append(c);
+                        case 'b':
+                            return append('\b');
+                        case 'f':
+                            return append('\f');
+                        case 'n':
+                            return append('\n');
+                        case 'r':
+                            return append('\r');
+                        case 't':
+                            return append('\t');
+                        case 'u':
+                            unicode_code  = 0;
+                            unicode_count = 0;
+                            state         = parse_state::string_unicode;
+                            return true;
+                        default:
+                            return fail();
+                    }
+
+                case parse_state::string_unicode:
+                {
+                    uint32_t digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : 16;
+                    if(digit == 16)
+                        return fail();
+                    unicode_code = unicode_code << 4 | digit;
+                    if(++unicode_count < 4)
+                        return true;
+
+                    state = parse_state::string;
+                    if(unicode_code >= 0xD800 && unicode_code < 0xDC00)
+                    {
+                        high_surrogate = unicode_code;
+                    }
+                    else if(unicode_code >= 0xDC00 && unicode_code < 0xE000 && high_surrogate != 0)
+                    {
+                        append_utf8(0x10000 + ((high_surrogate - 0xD800) << 10) + (unicode_code - 0xDC00));
+                        high_surrogate = 0;
+                    }
+                    else
+                    {
+                        append_utf8(unicode_code);
+                    }
+                    return state != parse_state::error;
+                }
+
+                case parse_state::number:
+                    if((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')
+                        return append(c);
+                    if(!is_json_number(token))
+                        return fail();
+                    for(size_t i = pending_begin(); i < sinks.size(); i++)
+                    {
+                        if(!sinks[i].on_number(token))
+                            return fail();
+                    }
+                    complete_value();
+                    return false;
+
+                case parse_state::literal:
+                    if(c != literal[literal_pos])
+                        return fail();
+                    if(literal[++literal_pos] == '\0')
+                    {
+                        if(literal[0] != 'n')
+                        {
+                            for(size_t i = pending_begin(); i < sinks.size(); i++)
+                                sinks[i].on_bool(literal[0] == 't');
+                        }
+                        complete_value();
+                    }
+                    return true;
+
+                case parse_state::done:
+                    return is_space(c) || fail();
+
+                case parse_state::error:
+                    return true;
+            }
+            return fail();
+        }
+
+        size_t                 max_token_size;
+        size_t                 max_depth;
+        std::vector<frame>     frames;
+        std::vector<json_sink> sinks;
+        std::string            token;
+        parse_state            state          = parse_state::value;
+        bool                   is_key         = false;
+        const char*            literal        = nullptr;
+        size_t                 literal_pos    = 0;
+        uint32_t               unicode_code   = 0;
+        uint32_t               unicode_count  = 0;
+        uint32_t               high_surrogate = 0;
+        size_t                 consumed       = 0;
+    };
+
+    // json_stream_decoder<Config> decoder(config);
+    // while((n = read(fd, buffer, sizeof(buffer))) > 0)
+    //     if(decoder.feed({buffer, size_t(n)}) != json_stream_status::need_more)
+    //         break;
+    template<class T>
+    class json_stream_decoder : public json_stream_parser
+    {
+    public:
+        explicit json_stream_decoder(T& value, size_t max_token_size = 64 * 1024, size_t max_depth = 64)
+            : json_stream_parser(make_json_sink(value), max_token_size, max_depth)
+        {
+        }
+
+        // decode the next document into value
+        void reset(T& value) { json_stream_parser::reset(make_json_sink(value)); }
+    };
+} // namespace static_reflection_v2
+
+#endif /* JSONSTREAMDECODER_H */
@@ -1,41 +1,187 @@
 #ifndef JSONTOSTRUCT_H
 #define JSONTOSTRUCT_H
 
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <span>
+
+#include "StaticEnum.h"
 #include "StaticHash.h"
+#include "StaticHashBatch.h"
 #include "StaticReflectionV2.h"
+#include "StringPool.h"
 #include "json.hpp"
 #include "type_traits_ext.h"
 
+// pmr-aware member: std::pmr::string, a pmr sequence like std::pmr::vector<...> or a pmr map like std::pmr::map<...>
+template<class FieldType>
+using is_pmr_field = std::uses_allocator<FieldType, std::pmr::polymorphic_allocator<std::byte>>;
+
+template<class FieldType>
+inline constexpr bool is_pmr_map = requires { typename FieldType::mapped_type; };
+
+template<class FieldType>
+inline constexpr bool is_pmr_sequence = requires(FieldType& f) {
+    f.clear();
+    f.emplace_back();
+    f.back();
+};
+
 // forward decal
 template<class T>
-inline void json_to_struct(const nlohmann::json& json, T& refStruct);
+inline void json_to_struct(const nlohmann::json& json, T& refStruct, std::pmr::memory_resource* resource);
 
 template<class FieldType>
-inline void json_to_field(const nlohmann::json& json, FieldType* field)
+inline void json_to_field(const nlohmann::json& json, FieldType* field, std::pmr::memory_resource* resource)
 {
-    if constexpr(is_invokable<decltype(&nlohmann::json::get<FieldType>), FieldType, nlohmann::json>::value)
+    if constexpr(have_meta_info<FieldType>::value)
+    {
+        json_to_struct(json, *field, resource);
+    }
+    else if constexpr(is_pmr_field<FieldType>::value)
+    {
+        // a pmr container keeps its resource for life, rebuild it on the requested one
+        if(resource != nullptr && field->get_allocator().resource() != resource)
+        {
+            std::destroy_at(field);
+            std::construct_at(field, resource);
+        }
+
+        if constexpr(std::is_same_v<FieldType, std::pmr::string>)
+        {
+            const auto& str = json.get_ref<const nlohmann::json::string_t&>();
+            field->assign(str.data(), str.size());
+        }
+        else if constexpr(is_pmr_map<FieldType>)
+        {
+            // a json object, keys and values built on the map's resource
+            field->clear();
+            for(const auto& [key, item]: json.get_ref<const nlohmann::json::object_t&>())
+            {
+                auto slot = field->try_emplace(std::make_obj_using_allocator<typename FieldType::key_type>(field->get_allocator(), key)).first;
+                json_to_field(item, &slot->second, resource);
+            }
+        }
+        else if constexpr(is_pmr_sequence<FieldType>)
+        {
+            field->clear();
+            if constexpr(requires { field->reserve(json.size()); })
+                field->reserve(json.size());
+            for(const auto& item: json)
+            {
+                // uses-allocator construction hands the resource to pmr elements
+                field->emplace_back();
+                json_to_field(item, &field->back(), resource);
+            }
+        }
+        else
+        {
+            // a pmr set and the like, the elements are not pmr-aware themselves here
+            json.get_to(*field);
+        }
+    }
+    else if constexpr(std::is_enum_v<FieldType>)
     {
-        *field = json.get<FieldType>();
+        if constexpr(have_enum_meta_info<FieldType>::value)
+        {
+            if(json.is_string())
+            {
+                static_reflection_v2::enum_from_string(json.get_ref<const nlohmann::json::string_t&>(), *field);
+                return;
+            }
+        }
+        *field = FieldType(json.get<std::underlying_type_t<FieldType>>());
     }
     else
     {
-        json_to_struct(json, *field);
+        json.get_to(*field);
     }
 }
 
+template<class FieldType>
+inline void json_to_field(const nlohmann::json& json, FieldType* field)
+{
+    json_to_field(json, field, nullptr);
+}
+
+// resource == nullptr: pmr members keep the resource they were constructed with
+// visit_set collects the top level members that were found and the keys that matched none
 template<class T>
-inline void json_to_struct(const nlohmann::json& json, T& refStruct)
+inline void json_to_struct(const nlohmann::json& json, T& refStruct, static_reflection_v2::FieldVisitSet<T>& visit_set,
+                           std::pmr::memory_resource* resource)
 {
-    for(const auto& [field_name, v]: json.items())
+    if(!json.is_object())
+        return;
+
+    auto to_field = [&refStruct, &visit_set, resource](size_t field_name_hash, const nlohmann::json& v)
     {
-        auto field_name_hash = static_reflection_v2::make_string_hash(field_name);
-        static_reflection_v2::FindInField(refStruct, field_name_hash, 
-        [&json](auto field_info, auto field) 
+        static_reflection_v2::FindInField(refStruct, field_name_hash, visit_set,
+        [&v, resource](const auto& field_info, auto& field, auto&&... extra)
         {
-            json_to_field(json, &field);
+            if constexpr(static_reflection_v2::is_intern_field<decltype(extra)...>)
+            {
+                if(v.is_string())
+                    static_reflection_v2::intern_to_field(v.get_ref<const nlohmann::json::string_t&>(), field);
+            }
+            else
+            {
+                json_to_field(v, &field, resource);
+            }
             return true;
         });
+    };
+
+    const auto& object = json.get_ref<const nlohmann::json::object_t&>();
+    if constexpr(std::is_same_v<static_reflection_v2::class_hash_policy_t<T>, hash::murmur3_policy>)
+    {
+        // the keys of an object are hashed 8 at a time by hash_many
+        constexpr size_t                              batch_size = 8;
+        std::array<std::string_view, batch_size>      keys;
+        std::array<const nlohmann::json*, batch_size> values;
+        std::array<uint32_t, batch_size>              hashes;
+        size_t                                        count = 0;
+
+        auto flush = [&]()
+        {
+            hash::hash_many(std::span(keys.data(), count), hashes);
+            for(size_t i = 0; i < count; i++)
+                to_field(hashes[i], *values[i]);
+            count = 0;
+        };
+        for(const auto& [field_name, v]: object)
+        {
+            keys[count]   = field_name;
+            values[count] = &v;
+            if(++count == batch_size)
+                flush();
+        }
+        flush();
+    }
+    else
+    {
+        for(const auto& [field_name, v]: object)
+            to_field(static_reflection_v2::make_string_hash<T>(field_name), v);
     }
 }
 
+template<class T>
+inline void json_to_struct(const nlohmann::json& json, T& refStruct, static_reflection_v2::FieldVisitSet<T>& visit_set)
+{
+    json_to_struct(json, refStruct, visit_set, nullptr);
+}
+
+template<class T>
+inline void json_to_struct(const nlohmann::json& json, T& refStruct, std::pmr::memory_resource* resource)
+{
+    static_reflection_v2::FieldVisitSet<T> visit_set;
+    json_to_struct(json, refStruct, visit_set, resource);
+}
+
+template<class T>
+inline void json_to_struct(const nlohmann::json& json, T& refStruct)
+{
+    json_to_struct(json, refStruct, nullptr);
+}
+
 #endif /* JSONTOSTRUCT_H */
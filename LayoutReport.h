@@ -0,0 +1,290 @@
+#ifndef LAYOUTREPORT_H
+#define LAYOUTREPORT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <type_traits>
+
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    inline constexpr size_t cache_line_size = 64;
+
+    struct LayoutMember
+    {
+        std::string_view name;
+        size_t           size;
+        size_t           align;
+        size_t           offset;         // laid out in DEFINE_META order
+        size_t           padding_before; // bytes between the previous member and this one
+        bool             crosses_line;   // starts and ends on different cache lines
+        bool             hot;            // META_MEMBER_HOT
+        int              bind;           // position in its META_MEMBER_BIND group, whose name every bind carries, -1 outside one
+    };
+
+    // size, align and padding of T are exact; offsets follow DEFINE_META order, the declaration order when
+    // DEFINE_META lists every member as declared, which check_layout<T>() confirms at runtime
+    template<size_t N>
+    struct LayoutReport
+    {
+        std::string_view                class_name;
+        size_t                          size;
+        size_t                          align;
+        size_t                          member_bytes;
+        size_t                          padding_bytes; // sizeof(T) - member_bytes, members DEFINE_META leaves out count here too, 0 when binds overlap
+        size_t                          cache_lines;
+        size_t                          crossing_count;
+        size_t                          hot_span;      // first hot byte to last hot byte, 0 without hot members
+        size_t                          optimal_size;  // members sorted by alignment, largest first
+        std::array<size_t, N>           suggested_order;
+        std::array<LayoutMember, N>     members;
+    };
+
+    template<class T>
+    constexpr size_t getLayoutMemberCount()
+    {
+        size_t count = 0;
+        for_each_tuple(getClassMetaInfo<T>().member_info_tuple,
+                       [&count](const auto& field_info) constexpr { for_each_member_bind(field_info, [&count](const auto&) constexpr { count++; }); });
+        return count;
+    }
+
+    // fn(bind_info, bind) for every data member, the binds of a group one by one
+    template<class T, class Fn>
+    constexpr void for_each_layout_member(Fn&& fn)
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        for_each_tuple(meta_class.member_info_tuple,
+                       [&fn](const auto& field_info) constexpr
+                       {
+                           int bind = is_member_ptr_group<decltype(field_info)>() ? 0 : -1;
+                           for_each_member_bind(field_info, [&fn, &bind](const auto& bind_info) constexpr { fn(bind_info, bind < 0 ? bind : bind++); });
+                       });
+    }
+
+    constexpr size_t align_up(size_t offset, size_t align)
+    {
+        return (offset + align - 1) / align * align;
+    }
+
+    template<class T>
+    constexpr auto getLayoutReport()
+    {
+        constexpr size_t         count = getLayoutMemberCount<T>();
+        LayoutReport<count>      report{};
+        size_t                   index = 0;
+        size_t                   end   = 0;
+        size_t                   hot_begin = size_t(-1);
+        size_t                   hot_end   = 0;
+
+        report.class_name = getClassMetaInfo<T>().class_name;
+        report.size       = sizeof(T);
+        report.align      = alignof(T);
+        for_each_layout_member<T>(
+            [&](const auto& bind_info, int bind) constexpr
+            {
+                using member_type = std::remove_reference_t<decltype(std::declval<T&>().*(bind_info.ptr))>;
+                bool hot          = false;
+                if constexpr(is_member_ptr_tag<decltype(bind_info)>())
+                    hot = std::is_same_v<std::decay_t<decltype(bind_info.tag)>, hot_tag>;
+
+                LayoutMember& member  = report.members[index++];
+                member.name           = bind_info.field_name;
+                member.size           = sizeof(member_type);
+                member.align          = alignof(member_type);
+                member.offset         = align_up(end, member.align);
+                member.padding_before = member.offset - end;
+                member.crosses_line   = member.offset / cache_line_size != (member.offset + member.size - 1) / cache_line_size;
+                member.hot            = hot;
+                member.bind           = bind;
+                end                   = member.offset + member.size;
+
+                report.member_bytes += member.size;
+                report.crossing_count += member.crosses_line;
+                if(hot)
+                {
+                    hot_begin = std::min(hot_begin, member.offset);
+                    hot_end   = std::max(hot_end, member.offset + member.size);
+                }
+            });
+
+        // union members or binds sharing bytes add up to more than sizeof(T)
+        report.padding_bytes = report.size > report.member_bytes ? report.size - report.member_bytes : 0;
+        report.cache_lines   = (report.size + cache_line_size - 1) / cache_line_size;
+        report.hot_span      = hot_end == 0 ? 0 : hot_end - hot_begin;
+
+        // hot members first so they share the first lines, then largest alignment first, stable otherwise
+        for(size_t i = 0; i < count; i++)
+        {
+            size_t pos = i;
+            for(; pos > 0; pos--)
+            {
+                const LayoutMember& previous = report.members[report.suggested_order[pos - 1]];
+                const LayoutMember& current  = report.members[i];
+                if(previous.hot > current.hot || (previous.hot == current.hot && previous.align >= current.align))
+                    break;
+                report.suggested_order[pos] = report.suggested_order[pos - 1];
+            }
+            report.suggested_order[pos] = i;
+        }
+
+        size_t optimal_end = 0;
+        for(size_t i: report.suggested_order)
+            optimal_end = align_up(optimal_end, report.members[i].align) + report.members[i].size;
+        report.optimal_size = align_up(optimal_end, report.align);
+        return report;
+    }
+
+    // static_assert(layout_within_budget<Session>(8)) - no more than 8 padding bytes, hot members inside one cache line
+    template<class T>
+    constexpr bool layout_within_budget(size_t max_padding_bytes, size_t max_hot_span = cache_line_size)
+    {
+        constexpr auto report = getLayoutReport<T>();
+        return report.padding_bytes <= max_padding_bytes && report.hot_span <= max_hot_span;
+    }
+
+    // real offsets, measured on storage that is never constructed, the way offsetof works
+    template<class T>
+    inline std::array<size_t, getLayoutMemberCount<T>()> measureLayoutOffsets()
+    {
+        alignas(T) static std::byte storage[sizeof(T)];
+        const T*                    object = reinterpret_cast<const T*>(storage);
+
+        std::array<size_t, getLayoutMemberCount<T>()> offsets{};
+        size_t                                        index = 0;
+        for_each_layout_member<T>([&](const auto& bind_info, int)
+                                  { offsets[index++] = size_t(reinterpret_cast<const std::byte*>(&(object->*(bind_info.ptr))) - storage); });
+        return offsets;
+    }
+
+    // the figures of getLayoutReport<T>() recomputed from the measured offsets, right whatever the DEFINE_META order
+    struct LayoutMeasure
+    {
+        size_t padding_bytes;  // sizeof(T) less the bytes some member covers, overlapping members counted once
+        size_t crossing_count;
+        size_t hot_span;
+    };
+
+    template<class T>
+    inline LayoutMeasure measureLayout()
+    {
+        constexpr auto report  = getLayoutReport<T>();
+        auto           offsets = measureLayoutOffsets<T>();
+
+        std::array<size_t, offsets.size()> rows{};
+        for(size_t i = 0; i < rows.size(); i++)
+            rows[i] = i;
+        std::sort(rows.begin(), rows.end(), [&offsets](size_t a, size_t b) { return offsets[a] < offsets[b]; });
+
+        LayoutMeasure measure{};
+        size_t        covered   = 0;
+        size_t        end       = 0;
+        size_t        hot_begin = size_t(-1);
+        size_t        hot_end   = 0;
+        for(size_t i: rows)
+        {
+            const auto& member = report.members[i];
+            size_t      begin  = offsets[i];
+            covered += begin + member.size > end ? begin + member.size - std::max(begin, end) : 0;
+            end = std::max(end, begin + member.size);
+            measure.crossing_count += begin / cache_line_size != (begin + member.size - 1) / cache_line_size;
+            if(member.hot)
+            {
+                hot_begin = std::min(hot_begin, begin);
+                hot_end   = std::max(hot_end, begin + member.size);
+            }
+        }
+        measure.padding_bytes = report.size - covered;
+        measure.hot_span      = hot_end == 0 ? 0 : hot_end - hot_begin;
+        return measure;
+    }
+
+    // layout_within_budget<T>() on the measured offsets
+    template<class T>
+    inline bool measured_within_budget(size_t max_padding_bytes, size_t max_hot_span = cache_line_size)
+    {
+        LayoutMeasure measure = measureLayout<T>();
+        return measure.padding_bytes <= max_padding_bytes && measure.hot_span <= max_hot_span;
+    }
+
+    // true if the offsets of getLayoutReport<T>() are the real ones, so budgets on hot_span hold
+    template<class T>
+    inline bool check_layout()
+    {
+        constexpr auto report  = getLayoutReport<T>();
+        auto           offsets = measureLayoutOffsets<T>();
+        for(size_t i = 0; i < offsets.size(); i++)
+        {
+            if(offsets[i] != report.members[i].offset)
+                return false;
+        }
+        return true;
+    }
+
+    template<class T>
+    inline void PrintLayoutReport(FILE* out)
+    {
+        constexpr auto report  = getLayoutReport<T>();
+        auto           offsets = measureLayoutOffsets<T>();
+        LayoutMeasure  measure = measureLayout<T>();
+
+        fprintf(out, "%.*s: size %zu align %zu, %zu member bytes, %zu padding, %zu cache lines, %zu crossing members", int(report.class_name.size()),
+                report.class_name.data(), report.size, report.align, report.member_bytes, measure.padding_bytes, report.cache_lines, measure.crossing_count);
+        if(measure.hot_span != 0)
+            fprintf(out, ", hot span %zu", measure.hot_span);
+        fprintf(out, "\n");
+        if(!check_layout<T>())
+            fprintf(out, "  DEFINE_META order differs from the declaration order: figures are measured, layout_within_budget<T>() assumes DEFINE_META order\n");
+
+        // rows in memory order
+        std::array<size_t, report.members.size()> rows{};
+        for(size_t i = 0; i < rows.size(); i++)
+            rows[i] = i;
+        std::stable_sort(rows.begin(), rows.end(), [&offsets](size_t a, size_t b) { return offsets[a] < offsets[b]; });
+
+        fprintf(out, "  %-32s %8s %6s %6s %6s\n", "member", "offset", "size", "align", "pad");
+        size_t end = 0;
+        for(size_t i: rows)
+        {
+            const auto& member = report.members[i];
+            char        name[64];
+            if(member.bind < 0)
+                snprintf(name, sizeof(name), "%.*s", int(member.name.size()), member.name.data());
+            else
+                snprintf(name, sizeof(name), "%.*s#%d", int(member.name.size()), member.name.data(), member.bind);
+            fprintf(out, "  %-32s %8zu %6zu %6zu %6zu%s%s\n", name, offsets[i], member.size, member.align, offsets[i] >= end ? offsets[i] - end : 0,
+                    offsets[i] / cache_line_size != (offsets[i] + member.size - 1) / cache_line_size ? " crosses line" : "", member.hot ? " hot" : "");
+            end = std::max(end, offsets[i] + member.size);
+        }
+        if(report.size > end)
+            fprintf(out, "  %-32s %8zu %6s %6s %6zu\n", "(tail)", end, "", "", report.size - end);
+
+        if(report.optimal_size < report.size || measure.hot_span > cache_line_size)
+        {
+            fprintf(out, "  suggested order, size %zu:", report.optimal_size);
+            for(size_t i: report.suggested_order)
+            {
+                const auto& member = report.members[i];
+                if(member.bind < 0)
+                    fprintf(out, " %.*s", int(member.name.size()), member.name.data());
+                else
+                    fprintf(out, " %.*s#%d", int(member.name.size()), member.name.data(), member.bind);
+            }
+            fprintf(out, "\n");
+        }
+    }
+
+    // PrintLayoutReport<ActionFlowLCast, ActionFlowNodeOneUnion>();
+    template<class... Types>
+    inline void PrintLayoutReport(FILE* out = stdout)
+        requires(sizeof...(Types) != 1)
+    {
+        (PrintLayoutReport<Types>(out), ...);
+    }
+} // namespace static_reflection_v2
+
+#endif /* LAYOUTREPORT_H */
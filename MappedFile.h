@@ -0,0 +1,128 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#include <string>
+#endif
+
+namespace static_reflection_v2
+{
+    // a read only file, mapped where mmap exists and read into memory elsewhere
+    class mapped_file
+    {
+    public:
+        mapped_file() = default;
+        explicit mapped_file(const char* path) { open(path); }
+        ~mapped_file() { close(); }
+
+        mapped_file(const mapped_file&)            = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept { swap(other); }
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if(this != &other)
+            {
+                close();
+                swap(other);
+            }
+            return *this;
+        }
+
+        // an empty file opens with an empty view
+        bool open(const char* path)
+        {
+            close();
+#if defined(__unix__) || defined(__APPLE__)
+            int fd = ::open(path, O_RDONLY);
+            if(fd < 0)
+                return false;
+            struct stat st;
+            if(fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            if(st.st_size != 0)
+            {
+                void* mapped = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapped == MAP_FAILED)
+                {
+                    ::close(fd);
+                    return false;
+                }
+                data = static_cast<const char*>(mapped);
+                size = size_t(st.st_size);
+            }
+            ::close(fd);
+#else
+            std::ifstream ifs(path, std::ios::binary);
+            if(!ifs)
+                return false;
+            storage.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+            data = storage.data();
+            size = storage.size();
+#endif
+            opened = true;
+            return true;
+        }
+
+        void close()
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            if(size != 0)
+                munmap(const_cast<char*>(data), size);
+#else
+            storage.clear();
+#endif
+            data   = nullptr;
+            size   = 0;
+            opened = false;
+        }
+
+        // front to back reads, lets the kernel read ahead further
+        void advise_sequential() const
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            if(size != 0)
+                madvise(const_cast<char*>(data), size, MADV_SEQUENTIAL);
+#endif
+        }
+
+        bool             is_open() const { return opened; }
+        std::string_view view() const { return std::string_view(data, size); }
+
+    private:
+        void swap(mapped_file& other)
+        {
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+            std::swap(opened, other.opened);
+#if !defined(__unix__) && !defined(__APPLE__)
+            std::swap(storage, other.storage);
+            data       = storage.data();
+            other.data = other.storage.data();
+#endif
+        }
+
+        const char* data   = nullptr;
+        size_t      size   = 0;
+        bool        opened = false;
+#if !defined(__unix__) && !defined(__APPLE__)
+        std::string storage;
+#endif
+    };
+} // namespace static_reflection_v2
+
+#endif /* MAPPEDFILE_H */
@@ -0,0 +1,844 @@
+#ifndef MESSAGEPACK_H
+#define MESSAGEPACK_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "StaticEnum.h"
+#include "StaticReflectionV2.h"
+#include "StringPool.h"
+
+namespace static_reflection_v2
+{
+    // name: maps keyed by field name, what other MessagePack speakers expect
+    // index: maps keyed by the member_info_tuple index, smaller but tied to the DEFINE_META order
+    enum class msgpack_keys
+    {
+        name,
+        index
+    };
+
+    constexpr size_t msgpack_str_header_size(size_t length)
+    {
+        return length < 32 ? 1 : length <= UINT8_MAX ? 2 : length <= UINT16_MAX ? 3 : 5;
+    }
+
+    // the encoded field names of a class, header included, built at compile time and copied as is
+    template<class T>
+    struct MsgPackKeyTable
+    {
+        static constexpr size_t size = getClassMemberSize<T>();
+
+        static constexpr size_t blob_size = []() constexpr
+        {
+            return std::apply([](const auto&... field_info) constexpr
+                              { return (size_t(0) + ... + (msgpack_str_header_size(std::string_view(field_info.field_name).size()) +
+                                                           std::string_view(field_info.field_name).size())); },
+                              getClassMetaInfo<T>().member_info_tuple);
+        }();
+
+        // offsets[i] .. offsets[i + 1] is the key of member i
+        static constexpr std::array<size_t, size + 1> offsets = []() constexpr
+        {
+            std::array<size_t, size + 1> table{};
+            size_t                       index = 0;
+            std::apply([&table, &index](const auto&... field_info) constexpr
+                       {
+                           ((table[index + 1] = table[index] + msgpack_str_header_size(std::string_view(field_info.field_name).size()) +
+                                                std::string_view(field_info.field_name).size(),
+                             index++),
+                            ...);
+                       },
+                       getClassMetaInfo<T>().member_info_tuple);
+            return table;
+        }();
+
+        static constexpr std::array<uint8_t, blob_size> blob = []() constexpr
+        {
+            std::array<uint8_t, blob_size> bytes{};
+            size_t                         pos    = 0;
+            auto                           append = [&bytes, &pos](std::string_view name) constexpr
+            {
+                size_t length = name.size();
+                if(length < 32)
+                {
+                    bytes[pos++] = uint8_t(0xA0 | length);
+                }
+                else if(length <= UINT8_MAX)
+                {
+                    bytes[pos++] = 0xD9;
+                    bytes[pos++] = uint8_t(length);
+                }
+                else if(length <= UINT16_MAX)
+                {
+                    bytes[pos++] = 0xDA;
+                    bytes[pos++] = uint8_t(length >> 8);
+                    bytes[pos++] = uint8_t(length);
+                }
+                else
+                {
+                    bytes[pos++] = 0xDB;
+                    for(int shift = 24; shift >= 0; shift -= 8)
+                        bytes[pos++] = uint8_t(length >> shift);
+                }
+                for(char c: name)
+                    bytes[pos++] = uint8_t(c);
+            };
+            std::apply([&append](const auto&... field_info) constexpr { (append(field_info.field_name), ...); }, getClassMetaInfo<T>().member_info_tuple);
+            return bytes;
+        }();
+
+        static std::span<const uint8_t> key(size_t index) { return std::span(blob.data() + offsets[index], offsets[index + 1] - offsets[index]); }
+    };
+
+    template<class FieldType>
+    inline constexpr bool is_msgpack_array = requires(FieldType& f) {
+        f.size();
+        f.clear();
+        f.emplace_back();
+        f.back();
+    };
+
+    template<class FieldType>
+    inline constexpr bool is_msgpack_string = !std::is_arithmetic_v<FieldType> && std::is_assignable_v<FieldType&, std::string_view> &&
+                                              std::is_convertible_v<const FieldType&, std::string_view>;
+
+    // a fixed char array is a C string, written as str up to its '\0'
+    template<class FieldType>
+    inline constexpr bool is_msgpack_char_array = std::is_array_v<FieldType> && std::is_same_v<std::remove_extent_t<FieldType>, char>;
+
+    // C arrays and std::array: exactly as many elements as the type holds
+    template<class FieldType>
+    inline constexpr bool is_msgpack_fixed_array = std::is_array_v<FieldType> || requires(FieldType& f) {
+        std::tuple_size<FieldType>::value;
+        std::begin(f);
+        std::end(f);
+    };
+
+    // std::map, std::unordered_map and the like are msgpack maps of key to value
+    template<class FieldType>
+    inline constexpr bool is_msgpack_map = requires(FieldType& f) {
+        typename FieldType::key_type;
+        typename FieldType::mapped_type;
+        f.clear();
+        f.emplace(std::declval<typename FieldType::key_type>(), std::declval<typename FieldType::mapped_type>());
+    };
+
+    // anything else with begin / end is written as an array
+    template<class FieldType>
+    inline constexpr bool is_msgpack_range = requires(const FieldType& f) {
+        std::begin(f);
+        std::end(f);
+    };
+
+    // a group is encoded as an array of its bind values, any other member as one value
+    template<class FieldInfo>
+    constexpr size_t msgpack_bind_count()
+    {
+        if constexpr(is_member_ptr_group<FieldInfo>())
+            return std::tuple_size_v<std::decay_t<decltype(std::declval<FieldInfo>().bind_tuple)>>;
+        else
+            return 1;
+    }
+
+    template<class T>
+    inline constexpr size_t msgpack_data_member_count = []()
+    {
+        size_t count = 0;
+        for_each_tuple(getClassMetaInfo<T>().member_info_tuple,
+                       [&count](const auto& field_info)
+                       {
+                           if constexpr(!is_member_func<decltype(field_info)>())
+                               count++;
+                       });
+        return count;
+    }();
+
+    // value read as int64_t, or as the bits of an uint64_t if is_unsigned, fits in Int
+    template<class Int>
+    constexpr bool msgpack_in_range(int64_t value, bool is_unsigned)
+    {
+        if(is_unsigned)
+            return uint64_t(value) <= uint64_t(std::numeric_limits<Int>::max());
+        return value >= int64_t(std::numeric_limits<Int>::min()) && (value < 0 || uint64_t(value) <= uint64_t(std::numeric_limits<Int>::max()));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // any byte container with insert(end, first, last): std::vector<std::byte>, std::vector<uint8_t>, std::string ...
+    template<class Buffer>
+    struct msgpack_writer
+    {
+        using byte_type = typename Buffer::value_type;
+        static_assert(sizeof(byte_type) == 1, "msgpack buffer must hold bytes");
+
+        Buffer& out;
+
+        void append(const uint8_t* data, size_t size)
+        {
+            const byte_type* first = reinterpret_cast<const byte_type*>(data);
+            out.insert(out.end(), first, first + size);
+        }
+
+        // marker followed by the low size bytes of value, big endian
+        void append_be(uint8_t marker, uint64_t value, size_t size)
+        {
+            uint8_t bytes[9] = {marker};
+            for(size_t i = 0; i < size; i++)
+                bytes[1 + i] = uint8_t(value >> ((size - 1 - i) * 8));
+            append(bytes, size + 1);
+        }
+
+        void write_nil() { append_be(0xC0, 0, 0); }
+        void write_bool(bool value) { append_be(value ? 0xC3 : 0xC2, 0, 0); }
+
+        void write_uint(uint64_t value)
+        {
+            if(value < 128)
+                append_be(uint8_t(value), 0, 0);
+            else if(value <= UINT8_MAX)
+                append_be(0xCC, value, 1);
+            else if(value <= UINT16_MAX)
+                append_be(0xCD, value, 2);
+            else if(value <= UINT32_MAX)
+                append_be(0xCE, value, 4);
+            else
+                append_be(0xCF, value, 8);
+        }
+
+        void write_int(int64_t value)
+        {
+            if(value >= 0)
+                write_uint(uint64_t(value));
+            else if(value >= -32)
+                append_be(uint8_t(value), 0, 0);
+            else if(value >= INT8_MIN)
+                append_be(0xD0, uint64_t(value), 1);
+            else if(value >= INT16_MIN)
+                append_be(0xD1, uint64_t(value), 2);
+            else if(value >= INT32_MIN)
+                append_be(0xD2, uint64_t(value), 4);
+            else
+                append_be(0xD3, uint64_t(value), 8);
+        }
+
+        void write_float(float value) { append_be(0xCA, std::bit_cast<uint32_t>(value), 4); }
+        void write_double(double value) { append_be(0xCB, std::bit_cast<uint64_t>(value), 8); }
+
+        void write_str(std::string_view str)
+        {
+            size_t length = str.size();
+            if(length < 32)
+                append_be(uint8_t(0xA0 | length), 0, 0);
+            else if(length <= UINT8_MAX)
+                append_be(0xD9, length, 1);
+            else if(length <= UINT16_MAX)
+                append_be(0xDA, length, 2);
+            else
+                append_be(0xDB, length, 4);
+            append(reinterpret_cast<const uint8_t*>(str.data()), length);
+        }
+
+        void write_array_header(size_t size)
+        {
+            if(size < 16)
+                append_be(uint8_t(0x90 | size), 0, 0);
+            else if(size <= UINT16_MAX)
+                append_be(0xDC, size, 2);
+            else
+                append_be(0xDD, size, 4);
+        }
+
+        void write_map_header(size_t size)
+        {
+            if(size < 16)
+                append_be(uint8_t(0x80 | size), 0, 0);
+            else if(size <= UINT16_MAX)
+                append_be(0xDE, size, 2);
+            else
+                append_be(0xDF, size, 4);
+        }
+
+        template<msgpack_keys Keys, class FieldType>
+        void write_value(const FieldType& field)
+        {
+            if constexpr(have_meta_info<FieldType>::value)
+            {
+                constexpr auto meta_class = getClassMetaInfo<FieldType>();
+                write_map_header(msgpack_data_member_count<FieldType>);
+                for_each_tuple_index(meta_class.member_info_tuple,
+                                     [this, &field](const auto& field_info, auto index)
+                                     {
+                                         if constexpr(!is_member_func<decltype(field_info)>())
+                                         {
+                                             if constexpr(Keys == msgpack_keys::index)
+                                                 write_uint(index);
+                                             else
+                                                 append(MsgPackKeyTable<FieldType>::key(index).data(), MsgPackKeyTable<FieldType>::key(index).size());
+
+                                             // a group writes [bind 0, bind 1, ...], every bound member keeps its own value
+                                             if constexpr(is_member_ptr_group<decltype(field_info)>())
+                                             {
+                                                 write_array_header(msgpack_bind_count<decltype(field_info)>());
+                                                 for_each_tuple(field_info.bind_tuple, [this, &field](const auto& bind_info) { write_value<Keys>(field.*(bind_info.ptr)); });
+                                             }
+                                             else
+                                             {
+                                                 write_value<Keys>(field.*(field_info.ptr));
+                                             }
+                                         }
+                                     });
+            }
+            else if constexpr(std::is_same_v<FieldType, bool>)
+            {
+                write_bool(field);
+            }
+            else if constexpr(std::is_enum_v<FieldType>)
+            {
+                if constexpr(std::is_signed_v<std::underlying_type_t<FieldType>>)
+                    write_int(int64_t(field));
+                else
+                    write_uint(uint64_t(field));
+            }
+            else if constexpr(std::is_integral_v<FieldType>)
+            {
+                if constexpr(std::is_signed_v<FieldType>)
+                    write_int(field);
+                else
+                    write_uint(field);
+            }
+            else if constexpr(std::is_same_v<FieldType, float>)
+            {
+                write_float(field);
+            }
+            else if constexpr(std::is_floating_point_v<FieldType>)
+            {
+                write_double(double(field));
+            }
+            else if constexpr(is_msgpack_string<FieldType>)
+            {
+                write_str(std::string_view(field));
+            }
+            else if constexpr(is_msgpack_char_array<FieldType>)
+            {
+                write_str(std::string_view(field, strnlen(field, std::extent_v<FieldType>)));
+            }
+            else if constexpr(is_msgpack_map<FieldType>)
+            {
+                write_map_header(field.size());
+                for(const auto& [key, item]: field)
+                {
+                    write_value<Keys>(key);
+                    write_value<Keys>(item);
+                }
+            }
+            else if constexpr(is_msgpack_range<FieldType>)
+            {
+                write_array_header(size_t(std::distance(std::begin(field), std::end(field))));
+                for(const auto& item: field)
+                    write_value<Keys>(item);
+            }
+            else
+            {
+                static_assert(sizeof(FieldType) == 0, "no msgpack form for this member type");
+            }
+        }
+    };
+
+    // std::vector<std::byte> buffer;
+    // to_msgpack(test, buffer);                       // keyed by field name
+    // to_msgpack<msgpack_keys::index>(test, buffer);  // keyed by member index
+    template<msgpack_keys Keys = msgpack_keys::name, class T, class Buffer>
+    inline void to_msgpack(const T& value, Buffer& out)
+    {
+        msgpack_writer<Buffer>{out}.template write_value<Keys>(value);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // every read checks the bounds, a failed read clears ok and leaves pos where it was
+    struct msgpack_reader
+    {
+        const uint8_t* pos;
+        const uint8_t* end;
+        bool           ok = true;
+
+        bool fail()
+        {
+            ok = false;
+            return false;
+        }
+
+        bool has(size_t size) const { return size_t(end - pos) >= size; }
+
+        uint64_t read_be(const uint8_t* p, size_t size) const
+        {
+            uint64_t value = 0;
+            for(size_t i = 0; i < size; i++)
+                value = value << 8 | p[i];
+            return value;
+        }
+
+        // marker at pos followed by a size byte big endian value
+        bool take(size_t size, uint64_t& value)
+        {
+            if(!has(1 + size))
+                return fail();
+            value = read_be(pos + 1, size);
+            pos += 1 + size;
+            return true;
+        }
+
+        bool is_array() const { return has(1) && ((*pos & 0xF0) == 0x90 || *pos == 0xDC || *pos == 0xDD); }
+
+        bool is_str() const { return has(1) && ((*pos & 0xE0) == 0xA0 || (*pos >= 0xD9 && *pos <= 0xDB) || (*pos >= 0xC4 && *pos <= 0xC6)); }
+
+        bool read_nil()
+        {
+            if(!has(1) || *pos != 0xC0)
+                return false;
+            pos++;
+            return true;
+        }
+
+        bool read_bool(bool& value)
+        {
+            if(!has(1) || (*pos != 0xC2 && *pos != 0xC3))
+                return fail();
+            value = *pos++ == 0xC3;
+            return true;
+        }
+
+        // any integer format, the caller narrows
+        bool read_int(int64_t& value, bool& is_unsigned)
+        {
+            if(!has(1))
+                return fail();
+            uint8_t  marker = *pos;
+            uint64_t raw    = 0;
+            is_unsigned     = false;
+            if(marker < 0x80)
+            {
+                value       = marker;
+                is_unsigned = true;
+                pos++;
+                return true;
+            }
+            if(marker >= 0xE0)
+            {
+                value = int8_t(marker);
+                pos++;
+                return true;
+            }
+            if(marker >= 0xCC && marker <= 0xCF)
+            {
+                // uint 8/16/32/64
+                if(!take(size_t(1) << (marker - 0xCC), raw))
+                    return false;
+                value       = int64_t(raw);
+                is_unsigned = true;
+                return true;
+            }
+            if(marker >= 0xD0 && marker <= 0xD3)
+            {
+                // int 8/16/32/64, sign extended from the top byte read
+                size_t size = size_t(1) << (marker - 0xD0);
+                if(!take(size, raw))
+                    return false;
+                value = int64_t(raw << (64 - size * 8)) >> (64 - size * 8);
+                return true;
+            }
+            return fail();
+        }
+
+        bool read_double(double& value)
+        {
+            uint64_t raw = 0;
+            if(has(1) && *pos == 0xCA)
+            {
+                if(!take(4, raw))
+                    return false;
+                value = std::bit_cast<float>(uint32_t(raw));
+                return true;
+            }
+            if(has(1) && *pos == 0xCB)
+            {
+                if(!take(8, raw))
+                    return false;
+                value = std::bit_cast<double>(raw);
+                return true;
+            }
+            int64_t i           = 0;
+            bool    is_unsigned = false;
+            if(!read_int(i, is_unsigned))
+                return false;
+            value = is_unsigned ? double(uint64_t(i)) : double(i);
+            return true;
+        }
+
+        // str or bin
+        bool read_str(std::string_view& str)
+        {
+            if(!has(1))
+                return fail();
+            const uint8_t* start  = pos;
+            uint8_t        marker = *pos;
+            uint64_t       length = 0;
+            if((marker & 0xE0) == 0xA0)
+            {
+                length = marker & 0x1F;
+                pos++;
+            }
+            else if(marker == 0xD9 || marker == 0xC4)
+            {
+                if(!take(1, length))
+                    return false;
+            }
+            else if(marker == 0xDA || marker == 0xC5)
+            {
+                if(!take(2, length))
+                    return false;
+            }
+            else if(marker == 0xDB || marker == 0xC6)
+            {
+                if(!take(4, length))
+                    return false;
+            }
+            else
+            {
+                return fail();
+            }
+            if(!has(length))
+            {
+                pos = start;
+                return fail();
+            }
+            str = std::string_view(reinterpret_cast<const char*>(pos), length);
+            pos += length;
+            return true;
+        }
+
+        bool read_container(uint8_t fix_marker, uint8_t marker16, uint8_t marker32, size_t& size)
+        {
+            if(!has(1))
+                return fail();
+            uint64_t value = 0;
+            if((*pos & 0xF0) == fix_marker)
+            {
+                value = *pos++ & 0x0F;
+            }
+            else if(*pos == marker16)
+            {
+                if(!take(2, value))
+                    return false;
+            }
+            else if(*pos == marker32)
+            {
+                if(!take(4, value))
+                    return false;
+            }
+            else
+            {
+                return fail();
+            }
+            size = size_t(value);
+            return true;
+        }
+
+        bool read_array_header(size_t& size) { return read_container(0x90, 0xDC, 0xDD, size); }
+        bool read_map_header(size_t& size) { return read_container(0x80, 0xDE, 0xDF, size); }
+
+        // one value of any type, nested ones included, without recursion
+        bool skip()
+        {
+            uint64_t pending = 1;
+            while(pending != 0)
+            {
+                pending--;
+                if(!has(1))
+                    return fail();
+                uint8_t  marker = *pos;
+                uint64_t size   = 0;
+                if(marker < 0x80 || marker >= 0xE0 || marker == 0xC0 || marker == 0xC2 || marker == 0xC3)
+                {
+                    pos++;
+                }
+                else if((marker & 0xF0) == 0x80 || marker == 0xDE || marker == 0xDF)
+                {
+                    size_t count = 0;
+                    if(!read_map_header(count))
+                        return false;
+                    pending += uint64_t(count) * 2;
+                }
+                else if((marker & 0xF0) == 0x90 || marker == 0xDC || marker == 0xDD)
+                {
+                    size_t count = 0;
+                    if(!read_array_header(count))
+                        return false;
+                    pending += count;
+                }
+                else if(is_str())
+                {
+                    std::string_view str;
+                    if(!read_str(str))
+                        return false;
+                }
+                else if(marker == 0xCA || marker == 0xCB || (marker >= 0xCC && marker <= 0xD3))
+                {
+                    // float 32/64, uint and int 8..64
+                    size = marker == 0xCA ? 4 : marker == 0xCB ? 8 : size_t(1) << ((marker - 0xCC) & 3);
+                }
+                else if(marker >= 0xD4 && marker <= 0xD8)
+                {
+                    // fixext 1..16: type byte and data
+                    size = 1 + (size_t(1) << (marker - 0xD4));
+                }
+                else if(marker >= 0xC7 && marker <= 0xC9)
+                {
+                    // ext 8/16/32: length, type byte, data
+                    size_t length_size = size_t(1) << (marker - 0xC7);
+                    if(!has(1 + length_size))
+                        return fail();
+                    size = length_size + 1 + read_be(pos + 1, length_size);
+                }
+                else
+                {
+                    return fail();
+                }
+
+                if(size != 0)
+                {
+                    if(!has(1 + size))
+                        return fail();
+                    pos += 1 + size;
+                }
+            }
+            return true;
+        }
+
+        template<class FieldType>
+        bool read_value(FieldType& field)
+        {
+            if constexpr(have_meta_info<FieldType>::value)
+            {
+                size_t count = 0;
+                if(!read_map_header(count))
+                    return false;
+                for(size_t i = 0; i < count; i++)
+                {
+                    if(!read_field(field))
+                        return fail();
+                }
+                return true;
+            }
+            else if constexpr(std::is_same_v<FieldType, bool>)
+            {
+                return read_bool(field);
+            }
+            else if constexpr(std::is_enum_v<FieldType> || std::is_integral_v<FieldType>)
+            {
+                if constexpr(std::is_enum_v<FieldType> && have_enum_meta_info<FieldType>::value)
+                {
+                    if(is_str())
+                    {
+                        // an unknown name leaves the field as it was
+                        std::string_view str;
+                        if(!read_str(str))
+                            return false;
+                        enum_from_string(str, field);
+                        return true;
+                    }
+                }
+                using int_type = typename std::conditional_t<std::is_enum_v<FieldType>, std::underlying_type<FieldType>, std::type_identity<FieldType>>::type;
+
+                // a value that does not fit the member is malformed input, not something to truncate
+                const uint8_t* start       = pos;
+                int64_t        value       = 0;
+                bool           is_unsigned = false;
+                if(!read_int(value, is_unsigned))
+                    return false;
+                if(!msgpack_in_range<int_type>(value, is_unsigned))
+                {
+                    pos = start;
+                    return fail();
+                }
+                field = FieldType(int_type(value));
+                return true;
+            }
+            else if constexpr(std::is_floating_point_v<FieldType>)
+            {
+                double value = 0;
+                if(!read_double(value))
+                    return false;
+                field = FieldType(value);
+                return true;
+            }
+            else if constexpr(is_msgpack_string<FieldType>)
+            {
+                static_assert(!std::is_same_v<FieldType, std::string_view>,
+                              "a std::string_view member would point into the input buffer, make it std::string or META_MEMBER_INTERN");
+                std::string_view str;
+                if(!read_str(str))
+                    return false;
+                field = str;
+                return true;
+            }
+            else if constexpr(is_msgpack_char_array<FieldType>)
+            {
+                // room for the '\0' is needed
+                std::string_view str;
+                if(!read_str(str))
+                    return false;
+                if(str.size() >= std::extent_v<FieldType>)
+                    return fail();
+                std::memcpy(field, str.data(), str.size());
+                std::memset(field + str.size(), 0, std::extent_v<FieldType> - str.size());
+                return true;
+            }
+            else if constexpr(is_msgpack_fixed_array<FieldType>)
+            {
+                size_t count = 0;
+                if(!read_array_header(count))
+                    return false;
+                if(count != std::size(field))
+                    return fail();
+                for(auto& item: field)
+                {
+                    if(!read_value(item))
+                        return false;
+                }
+                return true;
+            }
+            else if constexpr(is_msgpack_map<FieldType>)
+            {
+                size_t count = 0;
+                if(!read_map_header(count))
+                    return false;
+                field.clear();
+                for(size_t i = 0; i < count; i++)
+                {
+                    typename FieldType::key_type    key{};
+                    typename FieldType::mapped_type item{};
+                    if(!read_value(key) || !read_value(item))
+                        return fail();
+                    field.emplace(std::move(key), std::move(item));
+                }
+                return true;
+            }
+            else if constexpr(is_msgpack_array<FieldType>)
+            {
+                size_t count = 0;
+                if(!read_array_header(count))
+                    return false;
+                field.clear();
+                // every element takes a byte at least, a forged count can not reserve past the input
+                if constexpr(requires { field.reserve(count); })
+                    field.reserve(std::min(count, size_t(end - pos)));
+                for(size_t i = 0; i < count && ok; i++)
+                {
+                    field.emplace_back();
+                    read_value(field.back());
+                }
+                return ok;
+            }
+            else
+            {
+                return skip();
+            }
+        }
+
+        // a name key goes through the hash lookup, an integer key is a member index
+        template<class T>
+        bool read_field(T& value)
+        {
+            std::string_view name;
+            int64_t          index       = -1;
+            bool             is_unsigned = false;
+            bool             is_name     = is_str();
+            if(is_name ? !read_str(name) : !read_int(index, is_unsigned))
+                return false;
+
+            // a group gets [bind 0, bind 1, ...] from to_msgpack, one element per bind;
+            // a single value from another writer is decoded again into every bind
+            constexpr auto meta_class  = getClassMetaInfo<T>();
+            size_t         bind_count  = 1;
+            size_t         field_hash  = is_name ? make_string_hash<T>(name) : 0;
+            for_each_tuple_index(meta_class.member_info_tuple,
+                                 [&](const auto& field_info, auto idx)
+                                 {
+                                     if(is_name ? field_info.field_name_hash == field_hash : size_t(index) == idx)
+                                         bind_count = std::max(bind_count, msgpack_bind_count<decltype(field_info)>());
+                                 });
+
+            bool per_bind = false;
+            if(bind_count > 1 && is_array())
+            {
+                const uint8_t* start = pos;
+                size_t         count = 0;
+                if(!read_array_header(count))
+                    return false;
+                per_bind = count == bind_count;
+                if(!per_bind)
+                    pos = start;
+            }
+
+            const uint8_t* value_begin = pos;
+            const uint8_t* value_end   = pos;
+            auto           decode      = [this, per_bind, value_begin, &value_end](const auto&, auto& field, auto&&... extra)
+            {
+                if(!per_bind)
+                    pos = value_begin;
+                if constexpr(is_intern_field<decltype(extra)...>)
+                {
+                    // a value that is not a string leaves the member as it was
+                    std::string_view str;
+                    if(!is_str())
+                    {
+                        if(!skip())
+                            return false;
+                    }
+                    else
+                    {
+                        if(!read_str(str))
+                            return false;
+                        intern_to_field(str, field);
+                    }
+                }
+                else if(!read_value(field))
+                {
+                    return false;
+                }
+                value_end = pos;
+                return true;
+            };
+
+            bool found = is_name ? FindInField(value, field_hash, decode)
+                                 : index >= 0 && getClassMemberValueRef(value, size_t(index), decode);
+            if(!ok)
+                return false;
+            if(!found)
+                return skip();
+            pos = value_end;
+            return true;
+        }
+    };
+
+    // false on malformed or truncated input, value may be partly written then
+    // keys may be field names or member indices, unknown keys are skipped
+    template<class T>
+    inline bool from_msgpack(std::span<const std::byte> data, T& value)
+    {
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(data.data());
+        msgpack_reader reader{begin, begin + data.size()};
+        return reader.read_value(value) && reader.ok;
+    }
+} // namespace static_reflection_v2
+
+#endif /* MESSAGEPACK_H */
@@ -0,0 +1,140 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "StaticHash.h"
+
+namespace static_reflection_v2
+{
+    // not constexpr, so reaching it during constant evaluation is a compile error
+    inline void perfect_hash_duplicate_key() {}
+    inline void perfect_hash_build_failed() {}
+
+    // the sizes and reductions of perfect_hash_table<N>, also for a key count only known at runtime (hash_bench)
+    constexpr size_t perfect_hash_table_size(size_t count)
+    {
+        return count <= 1 ? 1 : std::bit_ceil(count) * 2;
+    }
+
+    constexpr size_t perfect_hash_bucket_size(size_t count)
+    {
+        return count / 4 + 1;
+    }
+
+    constexpr size_t perfect_hash_bucket(size_t hash, size_t bucket_size)
+    {
+        return hash::hash64shift(hash) % bucket_size;
+    }
+
+    // table_size is a power of two
+    constexpr size_t perfect_hash_slot(size_t hash, size_t pilot, size_t table_size)
+    {
+        return hash::hash64shift(hash ^ (pilot * 0x9E3779B97F4A7C15ULL)) & (table_size - 1);
+    }
+
+    // hash and displace: a key goes to bucket(hash), every bucket owns a pilot that moves its keys to free slots
+    // find() is two multiplications and one compare, whatever N is
+    template<size_t N>
+    struct perfect_hash_table
+    {
+        static constexpr size_t npos        = size_t(-1);
+        static constexpr size_t table_size  = perfect_hash_table_size(N);
+        static constexpr size_t bucket_size = perfect_hash_bucket_size(N);
+
+        std::array<size_t, bucket_size> pilot{};
+        std::array<size_t, table_size>  key{};
+        std::array<size_t, table_size>  index{};
+
+        static constexpr size_t bucket(size_t hash) { return perfect_hash_bucket(hash, bucket_size); }
+
+        static constexpr size_t slot(size_t hash, size_t pilot) { return perfect_hash_slot(hash, pilot, table_size); }
+
+        // position of hash in the source array, npos if absent
+        constexpr size_t find(size_t hash) const
+        {
+            size_t pos = slot(hash, pilot[bucket(hash)]);
+            return key[pos] == hash ? index[pos] : npos;
+        }
+    };
+
+    template<size_t N>
+    constexpr auto make_perfect_hash(const std::array<size_t, N>& hashes)
+    {
+        using table_t = perfect_hash_table<N>;
+        table_t table{};
+        for(auto& idx: table.index)
+            idx = table_t::npos;
+
+        for(size_t i = 0; i < N; i++)
+        {
+            for(size_t j = i + 1; j < N; j++)
+            {
+                if(hashes[i] == hashes[j])
+                    perfect_hash_duplicate_key();
+            }
+        }
+
+        // place the biggest buckets first, while the table is still empty
+        std::array<size_t, table_t::bucket_size> bucket_count{};
+        std::array<size_t, table_t::bucket_size> bucket_order{};
+        for(size_t i = 0; i < N; i++)
+            bucket_count[table_t::bucket(hashes[i])]++;
+        for(size_t b = 0; b < table_t::bucket_size; b++)
+        {
+            size_t pos = b;
+            while(pos > 0 && bucket_count[bucket_order[pos - 1]] < bucket_count[b])
+            {
+                bucket_order[pos] = bucket_order[pos - 1];
+                pos--;
+            }
+            bucket_order[pos] = b;
+        }
+
+        std::array<bool, table_t::table_size> used{};
+        for(size_t b: bucket_order)
+        {
+            if(bucket_count[b] == 0)
+                break;
+
+            size_t pilot = 0;
+            for(;; pilot++)
+            {
+                if(pilot > 0xFFFFF)
+                    perfect_hash_build_failed();
+
+                std::array<bool, table_t::table_size> taken = used;
+                bool                                  fit   = true;
+                for(size_t i = 0; i < N && fit; i++)
+                {
+                    if(table_t::bucket(hashes[i]) != b)
+                        continue;
+                    size_t pos = table_t::slot(hashes[i], pilot);
+                    fit        = !taken[pos];
+                    taken[pos] = true;
+                }
+                if(fit)
+                {
+                    used = taken;
+                    break;
+                }
+            }
+
+            table.pilot[b] = pilot;
+            for(size_t i = 0; i < N; i++)
+            {
+                if(table_t::bucket(hashes[i]) != b)
+                    continue;
+                size_t pos       = table_t::slot(hashes[i], pilot);
+                table.key[pos]   = hashes[i];
+                table.index[pos] = i;
+            }
+        }
+        return table;
+    }
+} // namespace static_reflection_v2
+
+#endif /* PERFECTHASH_H */
@@ -0,0 +1,206 @@
+#ifndef REFLECTPOOL_H
+#define REFLECTPOOL_H
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    template<class T, class = void>
+    struct has_clear : std::false_type
+    {
+    };
+
+    template<class T>
+    struct has_clear<T, std::void_t<decltype(std::declval<T&>().clear()), decltype(std::declval<const T&>().empty())>> : std::true_type
+    {
+    };
+
+    // default-constructed prototype, constant-initialized for literal types
+    template<class T>
+    struct reflect_prototype
+    {
+        static inline const T value{};
+    };
+
+    template<class T>
+    inline void ResetStruct(T& value, const T& prototype);
+
+    template<class FieldType>
+    inline void ResetField(FieldType& field, const FieldType& prototype)
+    {
+        if constexpr(std::is_trivially_copyable_v<FieldType>)
+        {
+            std::memcpy(&field, &prototype, sizeof(FieldType));
+        }
+        else if constexpr(have_meta_info<FieldType>::value)
+        {
+            ResetStruct(field, prototype);
+        }
+        else if constexpr(has_clear<FieldType>::value)
+        {
+            // string / vector: keep the capacity
+            if(prototype.empty())
+                field.clear();
+            else
+                field = prototype;
+        }
+        else
+        {
+            field = prototype;
+        }
+    }
+
+    // only reflected members are reset, unless T is trivially copyable
+    template<class T>
+    inline void ResetStruct(T& value, const T& prototype)
+    {
+        if constexpr(std::is_trivially_copyable_v<T>)
+        {
+            std::memcpy(&value, &prototype, sizeof(T));
+        }
+        else
+        {
+            constexpr auto meta_class = getClassMetaInfo<T>();
+            for_each_tuple(meta_class.member_info_tuple,
+                           [&value, &prototype](const auto& field_info)
+                           {
+                               for_each_member_bind(field_info,
+                                                    [&value, &prototype](const auto& bind_info)
+                                                    { ResetField(value.*(bind_info.ptr), prototype.*(bind_info.ptr)); });
+                           });
+        }
+    }
+
+    template<class T>
+    inline void ResetStruct(T& value)
+    {
+        ResetStruct(value, reflect_prototype<T>::value);
+    }
+
+    // objects are reset on release and stay constructed in the pool, so their buffers are reused
+    // acquire/release hit a thread-local free list, overflow and refill go through a global lock-free stack
+    template<class T, size_t LocalCapacity = 64>
+    class reflect_pool
+    {
+        struct node
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+            node* next;
+        };
+
+        static T*    to_object(node* n) { return std::launder(reinterpret_cast<T*>(n->storage)); }
+        static node* to_node(T* obj) { return reinterpret_cast<node*>(reinterpret_cast<unsigned char*>(obj)); }
+
+        static void free_list(node* head)
+        {
+            while(head != nullptr)
+            {
+                node* next = head->next;
+                std::destroy_at(to_object(head));
+                delete head;
+                head = next;
+            }
+        }
+
+        struct global_list
+        {
+            std::atomic<node*> head{nullptr};
+            ~global_list() { free_list(head.exchange(nullptr)); }
+
+            // push is ABA-safe, and pop only ever takes the whole stack
+            void push(node* n)
+            {
+                n->next = head.load(std::memory_order_relaxed);
+                while(!head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed))
+                {
+                }
+            }
+            node* take_all() { return head.exchange(nullptr, std::memory_order_acquire); }
+        };
+
+        struct local_list
+        {
+            node*  head  = nullptr;
+            size_t count = 0;
+            ~local_list()
+            {
+                while(head != nullptr)
+                {
+                    node* next = head->next;
+                    global().push(head);
+                    head = next;
+                }
+            }
+        };
+
+        static global_list& global()
+        {
+            static global_list list;
+            return list;
+        }
+
+        static local_list& local()
+        {
+            thread_local local_list list;
+            return list;
+        }
+
+    public:
+        struct releaser
+        {
+            void operator()(T* obj) const { reflect_pool::release(obj); }
+        };
+        using ptr = std::unique_ptr<T, releaser>;
+
+        static T* acquire()
+        {
+            auto& list = local();
+            if(list.head == nullptr)
+            {
+                list.head = global().take_all();
+                for(node* n = list.head; n != nullptr; n = n->next)
+                    list.count++;
+            }
+
+            if(list.head != nullptr)
+            {
+                node* n   = list.head;
+                list.head = n->next;
+                list.count--;
+                return to_object(n);
+            }
+
+            node* n = new node;
+            return ::new(static_cast<void*>(n->storage)) T{};
+        }
+
+        static void release(T* obj)
+        {
+            if(obj == nullptr)
+                return;
+
+            ResetStruct(*obj);
+
+            node* n    = to_node(obj);
+            auto& list = local();
+            if(list.count >= LocalCapacity)
+            {
+                global().push(n);
+                return;
+            }
+            n->next   = list.head;
+            list.head = n;
+            list.count++;
+        }
+
+        static ptr make() { return ptr(acquire()); }
+    };
+} // namespace static_reflection_v2
+
+#endif /* REFLECTPOOL_H */
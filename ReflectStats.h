@@ -0,0 +1,260 @@
+#ifndef REFLECTSTATS_H
+#define REFLECTSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(STATIC_REFLECTION_STATS_TIMING) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+// FindInField counters, compiled in with -DSTATIC_REFLECTION_ENABLE_STATS
+// json_to_struct and the XML loader look fields up through FindInField, so they are counted as well
+//   hit:     the name matched a field and fn returned true
+//   miss:    the name matched a field and fn returned false
+//   unknown: no field has this name hash
+// -DSTATIC_REFLECTION_STATS_TIMING adds the time spent in fn per field, in cycles on x86 and nanoseconds elsewhere
+
+#ifndef STATIC_REFLECTION_STATS_SLOTS
+#define STATIC_REFLECTION_STATS_SLOTS 4096
+#endif
+
+namespace static_reflection_v2
+{
+    namespace stats
+    {
+#if defined(STATIC_REFLECTION_STATS_TIMING) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__))
+        inline constexpr const char* ticks_unit = "cycles";
+#else
+        inline constexpr const char* ticks_unit = "ns";
+#endif
+
+        inline uint64_t now_ticks()
+        {
+#if defined(STATIC_REFLECTION_STATS_TIMING) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__))
+            return __rdtsc();
+#else
+            return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+
+        struct field_totals
+        {
+            std::string field_name;
+            uint64_t    hits    = 0;
+            uint64_t    misses  = 0;
+            uint64_t    unknown = 0;
+            uint64_t    ticks   = 0;
+        };
+
+        // (class_name, field_name_hash)
+        using totals_map = std::map<std::pair<std::string, uint64_t>, field_totals>;
+
+        // written by its own thread only, read by the exporter: every counter is a relaxed load + store, never an RMW
+        struct stat_slot
+        {
+            std::atomic<const char*> class_name{nullptr}; // published last, the slot is in use once it is set
+            std::atomic<const char*> field_name{nullptr};
+            std::atomic<uint64_t>    field_hash{0};
+            std::atomic<uint64_t>    hits{0};
+            std::atomic<uint64_t>    misses{0};
+            std::atomic<uint64_t>    unknown{0};
+            std::atomic<uint64_t>    ticks{0};
+        };
+
+        inline void bump(std::atomic<uint64_t>& counter, uint64_t n)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        inline void merge_slot(totals_map& totals, const stat_slot& slot)
+        {
+            const char* class_name = slot.class_name.load(std::memory_order_acquire);
+            if(class_name == nullptr)
+                return;
+
+            auto& field = totals[{class_name, slot.field_hash.load(std::memory_order_relaxed)}];
+            if(const char* field_name = slot.field_name.load(std::memory_order_relaxed); field_name != nullptr)
+                field.field_name = field_name;
+            field.hits += slot.hits.load(std::memory_order_relaxed);
+            field.misses += slot.misses.load(std::memory_order_relaxed);
+            field.unknown += slot.unknown.load(std::memory_order_relaxed);
+            field.ticks += slot.ticks.load(std::memory_order_relaxed);
+        }
+
+        struct thread_stats;
+
+        struct stats_registry
+        {
+            std::mutex                 mutex;
+            std::vector<thread_stats*> threads;
+            totals_map                 retired; // counters of threads that already exited
+            std::atomic<uint64_t>      dropped{0};
+
+            static stats_registry& instance()
+            {
+                static stats_registry registry;
+                return registry;
+            }
+        };
+
+        struct thread_stats
+        {
+            static constexpr size_t slot_count = STATIC_REFLECTION_STATS_SLOTS;
+            static_assert((slot_count & (slot_count - 1)) == 0, "STATIC_REFLECTION_STATS_SLOTS must be a power of 2");
+
+            std::unique_ptr<stat_slot[]> slots{new stat_slot[slot_count]};
+
+            thread_stats()
+            {
+                auto&            registry = stats_registry::instance();
+                std::scoped_lock lock(registry.mutex);
+                registry.threads.push_back(this);
+            }
+
+            ~thread_stats()
+            {
+                auto&            registry = stats_registry::instance();
+                std::scoped_lock lock(registry.mutex);
+                for(size_t i = 0; i < slot_count; i++)
+                    merge_slot(registry.retired, slots[i]);
+                std::erase(registry.threads, this);
+            }
+
+            static thread_stats& local()
+            {
+                thread_local thread_stats stats;
+                return stats;
+            }
+
+            // nullptr once the table is full, the event is counted as dropped
+            stat_slot* find_slot(const char* class_name, uint64_t field_hash)
+            {
+                uint64_t mix = (field_hash ^ uint64_t(reinterpret_cast<uintptr_t>(class_name))) * 0x9E3779B97F4A7C15ULL;
+                for(size_t probe = 0; probe < slot_count; probe++)
+                {
+                    auto&       slot = slots[(size_t(mix >> 32) + probe) & (slot_count - 1)];
+                    const char* used = slot.class_name.load(std::memory_order_relaxed);
+                    if(used == nullptr)
+                    {
+                        slot.field_hash.store(field_hash, std::memory_order_relaxed);
+                        slot.class_name.store(class_name, std::memory_order_release);
+                        return &slot;
+                    }
+                    if(used == class_name && slot.field_hash.load(std::memory_order_relaxed) == field_hash)
+                        return &slot;
+                }
+                // shared by every thread, so this one is an RMW
+                stats_registry::instance().dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        };
+
+        inline void record_field(const char* class_name, const char* field_name, uint64_t field_hash, bool hit, uint64_t ticks)
+        {
+            stat_slot* slot = thread_stats::local().find_slot(class_name, field_hash);
+            if(slot == nullptr)
+                return;
+            if(slot->field_name.load(std::memory_order_relaxed) == nullptr)
+                slot->field_name.store(field_name, std::memory_order_relaxed);
+            bump(hit ? slot->hits : slot->misses, 1);
+            bump(slot->ticks, ticks);
+        }
+
+        inline void record_unknown(const char* class_name, uint64_t field_hash)
+        {
+            if(stat_slot* slot = thread_stats::local().find_slot(class_name, field_hash))
+                bump(slot->unknown, 1);
+        }
+
+        // wraps the fn of FindInField, a group calls it once per bound member
+        template<class Fn>
+        struct counted_fn
+        {
+            const char* class_name;
+            uint64_t    field_hash;
+            Fn&         fn;
+            bool        found = false;
+
+            template<class FieldInfo, class... Args>
+            bool operator()(const FieldInfo& field_info, Args&&... args)
+            {
+                found = true;
+#ifdef STATIC_REFLECTION_STATS_TIMING
+                uint64_t start  = now_ticks();
+                bool     result = fn(field_info, std::forward<Args>(args)...);
+                record_field(class_name, field_info.field_name, field_hash, result, now_ticks() - start);
+#else
+                bool result = fn(field_info, std::forward<Args>(args)...);
+                record_field(class_name, field_info.field_name, field_hash, result, 0);
+#endif
+                return result;
+            }
+        };
+
+        // live threads plus the ones that exited, merged by (class name, field hash)
+        inline totals_map collect()
+        {
+            auto&            registry = stats_registry::instance();
+            std::scoped_lock lock(registry.mutex);
+            totals_map       totals = registry.retired;
+            for(thread_stats* thread: registry.threads)
+            {
+                for(size_t i = 0; i < thread_stats::slot_count; i++)
+                    merge_slot(totals, thread->slots[i]);
+            }
+            return totals;
+        }
+
+        inline void append_json_string(std::string& out, std::string_view str)
+        {
+            out += '"';
+            for(char c: str)
+            {
+                if(c == '"' || c == '\\')
+                    out += '\\';
+                if(uint8_t(c) >= 0x20)
+                    out += c;
+            }
+            out += '"';
+        }
+
+        // {"ticks_unit":"cycles","dropped":0,"fields":[{"class":"ActionFlowLCast","field":"castTime","hash":...,"hits":1,"misses":0,"unknown":0,"ticks":0},...]}
+        // an unknown key has no field name, "field" is null
+        inline std::string export_json()
+        {
+            totals_map  totals = collect();
+            std::string out    = std::string("{\"ticks_unit\":\"") + ticks_unit + "\",\"dropped\":";
+            bool        first  = true;
+            out += std::to_string(stats_registry::instance().dropped.load(std::memory_order_relaxed)) + ",\"fields\":[";
+            for(const auto& [key, field]: totals)
+            {
+                out += first ? "{\"class\":" : ",{\"class\":";
+                first = false;
+                append_json_string(out, key.first);
+                out += ",\"field\":";
+                if(field.field_name.empty())
+                    out += "null";
+                else
+                    append_json_string(out, field.field_name);
+                out += ",\"hash\":" + std::to_string(key.second);
+                out += ",\"hits\":" + std::to_string(field.hits);
+                out += ",\"misses\":" + std::to_string(field.misses);
+                out += ",\"unknown\":" + std::to_string(field.unknown);
+                out += ",\"ticks\":" + std::to_string(field.ticks) + "}";
+            }
+            out += "]}";
+            return out;
+        }
+    } // namespace stats
+} // namespace static_reflection_v2
+
+#endif /* REFLECTSTATS_H */
@@ -0,0 +1,313 @@
+#ifndef RELOADABLE_H
+#define RELOADABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "JsonToStruct.h"
+
+namespace static_reflection_v2
+{
+    template<class T, class = void>
+    struct is_equality_comparable : std::false_type
+    {
+    };
+
+    template<class T>
+    struct is_equality_comparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>> : std::true_type
+    {
+    };
+
+    template<class T>
+    inline bool IsStructEqual(const T& lhs, const T& rhs);
+
+    template<class FieldType>
+    inline bool IsFieldEqual(const FieldType& lhs, const FieldType& rhs)
+    {
+        if constexpr(std::is_array_v<FieldType>)
+        {
+            return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), [](const auto& l, const auto& r) { return IsFieldEqual(l, r); });
+        }
+        else if constexpr(have_meta_info<FieldType>::value)
+        {
+            return IsStructEqual(lhs, rhs);
+        }
+        else if constexpr(is_equality_comparable<FieldType>::value)
+        {
+            return lhs == rhs;
+        }
+        else if constexpr(std::is_trivially_copyable_v<FieldType>)
+        {
+            return std::memcmp(&lhs, &rhs, sizeof(FieldType)) == 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    template<class T, class Fn>
+    inline void ForEachChangedField(const T& lhs, const T& rhs, Fn&& fn)
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        for_each_tuple(meta_class.member_info_tuple,
+                       [&lhs, &rhs, &fn](const auto& field_info)
+                       {
+                           bool equal = true;
+                           for_each_member_bind(field_info,
+                                                [&lhs, &rhs, &equal](const auto& bind_info)
+                                                { equal = equal && IsFieldEqual(lhs.*(bind_info.ptr), rhs.*(bind_info.ptr)); });
+                           if(!equal)
+                               fn(field_info);
+                       });
+    }
+
+    template<class T>
+    inline bool IsStructEqual(const T& lhs, const T& rhs)
+    {
+        bool equal = true;
+        ForEachChangedField(lhs, rhs, [&equal](const auto&) { equal = false; });
+        return equal;
+    }
+
+    // epoch based reclamation shared by every reloadable<T>
+    // a reader announces the global epoch it entered in, a writer retires a snapshot at the epoch it was replaced in,
+    // and frees it once every announced epoch is newer
+    // a thread keeps its reader slot until it exits; with all MAX_READER_THREAD slots taken, readers share one overflow slot
+    // under a short lock that holds the oldest epoch any of them entered in, which only delays reclamation
+    class rcu_domain
+    {
+    public:
+        static constexpr size_t MAX_READER_THREAD = 256;
+
+        static rcu_domain& instance()
+        {
+            static rcu_domain domain;
+            return domain;
+        }
+
+        void read_lock()
+        {
+            auto& reader = this_reader();
+            if(reader.depth++ != 0)
+                return;
+            if(reader.slot == no_slot)
+                reader.slot = acquire_slot();
+            if(reader.slot != no_slot)
+            {
+                slots[reader.slot].epoch.store(global_epoch.load());
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            if(overflow_readers++ == 0)
+                overflow_epoch = global_epoch.load();
+        }
+
+        void read_unlock()
+        {
+            auto& reader = this_reader();
+            if(--reader.depth != 0)
+                return;
+            if(reader.slot != no_slot)
+            {
+                slots[reader.slot].epoch.store(0, std::memory_order_release);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            if(--overflow_readers == 0)
+                overflow_epoch = 0;
+        }
+
+        // call after the old snapshot is unpublished
+        uint64_t retire_epoch() { return global_epoch.fetch_add(1); }
+
+        uint64_t min_active_epoch() const
+        {
+            uint64_t min_epoch = UINT64_MAX;
+            for(const auto& slot: slots)
+            {
+                uint64_t epoch = slot.epoch.load();
+                if(epoch != 0)
+                    min_epoch = std::min(min_epoch, epoch);
+            }
+
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            if(overflow_epoch != 0)
+                min_epoch = std::min(min_epoch, overflow_epoch);
+            return min_epoch;
+        }
+
+    private:
+        struct alignas(64) reader_slot
+        {
+            std::atomic<uint64_t> epoch{0};
+            std::atomic<bool>     used{false};
+        };
+
+        static constexpr size_t no_slot = size_t(-1);
+
+        // the slot goes back to the domain when the thread exits
+        struct reader_info
+        {
+            rcu_domain* domain;
+            size_t      slot  = no_slot;
+            size_t      depth = 0;
+            ~reader_info()
+            {
+                if(slot != no_slot)
+                    domain->slots[slot].used.store(false, std::memory_order_release);
+            }
+        };
+
+        reader_info& this_reader()
+        {
+            thread_local reader_info reader{this};
+            return reader;
+        }
+
+        // no_slot if every slot is taken, the caller reads through the overflow slot then
+        size_t acquire_slot()
+        {
+            for(size_t i = 0; i < MAX_READER_THREAD; i++)
+            {
+                bool used = false;
+                if(!slots[i].used.load(std::memory_order_relaxed) && slots[i].used.compare_exchange_strong(used, true, std::memory_order_acquire))
+                    return i;
+            }
+            return no_slot;
+        }
+
+        std::atomic<uint64_t> global_epoch{1};
+        reader_slot           slots[MAX_READER_THREAD];
+
+        mutable std::mutex overflow_mutex;
+        size_t             overflow_readers = 0;
+        uint64_t           overflow_epoch   = 0;
+    };
+
+    // config snapshot published by pointer swap, readers never block on a writer
+    //   auto config = g_config.read();
+    //   use(config->field);
+    template<class T>
+    class reloadable
+    {
+    public:
+        class snapshot
+        {
+        public:
+            explicit snapshot(const reloadable& owner)
+            {
+                rcu_domain::instance().read_lock();
+                ptr = owner.current.load();
+            }
+            snapshot(const snapshot&)            = delete;
+            snapshot& operator=(const snapshot&) = delete;
+            ~snapshot() { rcu_domain::instance().read_unlock(); }
+
+            const T& operator*() const { return *ptr; }
+            const T* operator->() const { return ptr; }
+            const T* get() const { return ptr; }
+
+        private:
+            const T* ptr;
+        };
+
+        explicit reloadable(T value = T{})
+            : current(new T(std::move(value)))
+        {
+        }
+
+        reloadable(const reloadable&)            = delete;
+        reloadable& operator=(const reloadable&) = delete;
+
+        // no reader may outlive the reloadable
+        ~reloadable()
+        {
+            delete current.load();
+            for(auto& retired: retired_list)
+                delete retired.first;
+        }
+
+        snapshot read() const { return snapshot(*this); }
+
+        void publish(T value)
+        {
+            publish(std::move(value), [](const auto&) {});
+        }
+
+        // on_change(field_info) is called for each top level member that differs from the previous snapshot
+        template<class Fn>
+        void publish(T value, Fn&& on_change)
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex);
+
+            const T* new_ptr = new T(std::move(value));
+            const T* old_ptr = current.exchange(new_ptr);
+            ForEachChangedField(*old_ptr, *new_ptr, std::forward<Fn>(on_change));
+
+            retired_list.emplace_back(old_ptr, rcu_domain::instance().retire_epoch());
+            reclaim();
+        }
+
+        bool reload(const std::string& file_name)
+        {
+            return reload(file_name, [](const auto&) {});
+        }
+
+        // parse off the hot path, publish only if the whole file is valid json and every value fits its member
+        template<class Fn>
+        bool reload(const std::string& file_name, Fn&& on_change)
+        {
+            std::ifstream ifs(file_name);
+            if(!ifs)
+                return false;
+
+            auto json = nlohmann::json::parse(ifs, nullptr, false);
+            if(json.is_discarded())
+                return false;
+
+            T value{};
+            try
+            {
+                json_to_struct(json, value);
+            }
+            catch(const nlohmann::json::exception&)
+            {
+                // a string where a number belongs and the like
+                return false;
+            }
+            publish(std::move(value), std::forward<Fn>(on_change));
+            return true;
+        }
+
+    private:
+        void reclaim()
+        {
+            uint64_t min_epoch = rcu_domain::instance().min_active_epoch();
+            auto     it        = std::remove_if(retired_list.begin(),
+                                     retired_list.end(),
+                                     [min_epoch](const auto& retired)
+                                     {
+                                         if(retired.second >= min_epoch)
+                                             return false;
+                                         delete retired.first;
+                                         return true;
+                                     });
+            retired_list.erase(it, retired_list.end());
+        }
+
+        std::atomic<const T*>                       current;
+        std::mutex                                  writer_mutex;
+        std::vector<std::pair<const T*, uint64_t>> retired_list;
+    };
+} // namespace static_reflection_v2
+
+#endif /* RELOADABLE_H */
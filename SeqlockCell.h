@@ -0,0 +1,218 @@
+#ifndef SEQLOCKCELL_H
+#define SEQLOCKCELL_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "LayoutReport.h"
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    // the bytes of the reflected members of T, adjacent members merged into one range
+    template<class T>
+    struct seqlock_ranges
+    {
+        struct range
+        {
+            size_t begin;
+            size_t end;
+        };
+
+        static const std::vector<range>& get()
+        {
+            static const std::vector<range> ranges = []()
+            {
+                constexpr auto report  = getLayoutReport<T>();
+                auto           offsets = measureLayoutOffsets<T>();
+
+                std::vector<range> sorted;
+                for(size_t i = 0; i < offsets.size(); i++)
+                    sorted.push_back(range{offsets[i], offsets[i] + report.members[i].size});
+                std::sort(sorted.begin(), sorted.end(), [](const range& a, const range& b) { return a.begin < b.begin; });
+
+                std::vector<range> merged;
+                for(const range& r: sorted)
+                {
+                    if(!merged.empty() && r.begin <= merged.back().end)
+                        merged.back().end = std::max(merged.back().end, r.end);
+                    else
+                        merged.push_back(r);
+                }
+                return merged;
+            }();
+            return ranges;
+        }
+    };
+
+    // one writer publishes T, any number of readers copy it without a lock and retry when the copy was torn
+    // the data is copied in 8 byte relaxed atomics between the sequence loads, members DEFINE_META leaves out are not published
+    // seqlock_cell<Quote> cell;
+    // cell.store(quote);                        // writer
+    // Quote last = cell.load();                 // reader
+    // double bid = cell.load_member<0>();       // reader, one member
+    template<class T>
+    class seqlock_cell
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "seqlock_cell copies T as bytes, T has to be trivially copyable");
+
+    public:
+        using value_type = T;
+
+        static constexpr size_t word_count = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        seqlock_cell()
+            : seqlock_cell(T{})
+        {
+        }
+
+        explicit seqlock_cell(const T& value)
+        {
+            write_words(value, 0, sizeof(T));
+        }
+
+        seqlock_cell(const seqlock_cell&)            = delete;
+        seqlock_cell& operator=(const seqlock_cell&) = delete;
+
+        // single writer only
+        void store(const T& value)
+        {
+            begin_write();
+            for(const auto& r: seqlock_ranges<T>::get())
+                write_words(value, r.begin, r.end);
+            end_write();
+        }
+
+        // the reflected members of out are overwritten, the others are left as they are
+        void load(T& out) const
+        {
+            uint64_t    buffer[word_count];
+            const auto& ranges = seqlock_ranges<T>::get();
+            read_consistent(
+                [this, &buffer, &ranges]()
+                {
+                    for(const auto& r: ranges)
+                        read_words(buffer, r.begin, r.end);
+                });
+
+            for(const auto& r: ranges)
+                std::memcpy(reinterpret_cast<std::byte*>(&out) + r.begin, reinterpret_cast<const std::byte*>(buffer) + r.begin, r.end - r.begin);
+        }
+
+        T load() const
+        {
+            T out{};
+            load(out);
+            return out;
+        }
+
+        // member N of member_info_tuple alone, only its words are copied
+        template<auto N>
+        auto load_member() const
+        {
+            using member_type = typename member_ptr_traits<std::decay_t<decltype(getClassMemberPtr<T, N>())>>::member_type;
+            static_assert(!std::is_array_v<member_type>, "load_member returns the member by value, use std::array for array members");
+
+            size_t   begin = member_offset<N>();
+            uint64_t buffer[word_count];
+            read_consistent([this, &buffer, begin]() { read_words(buffer, begin, begin + sizeof(member_type)); });
+
+            member_type value;
+            std::memcpy(&value, reinterpret_cast<const std::byte*>(buffer) + begin, sizeof(member_type));
+            return value;
+        }
+
+        // single writer only; readers of other members whose words it shares retry too
+        template<auto N, class Value>
+        void store_member(const Value& value)
+        {
+            using member_type = typename member_ptr_traits<std::decay_t<decltype(getClassMemberPtr<T, N>())>>::member_type;
+            static_assert(std::is_same_v<member_type, Value>, "store_member takes the exact member type");
+
+            size_t begin = member_offset<N>();
+            size_t end   = begin + sizeof(member_type);
+            begin_write();
+            for(size_t word = begin / sizeof(uint64_t); word * sizeof(uint64_t) < end; word++)
+            {
+                // the writer owns every word, patching in its bytes is no race
+                uint64_t bits       = words[word].load(std::memory_order_relaxed);
+                size_t   word_begin = word * sizeof(uint64_t);
+                size_t   from       = std::max(begin, word_begin);
+                size_t   to         = std::min(end, word_begin + sizeof(uint64_t));
+                std::memcpy(reinterpret_cast<std::byte*>(&bits) + (from - word_begin), reinterpret_cast<const std::byte*>(&value) + (from - begin), to - from);
+                words[word].store(bits, std::memory_order_relaxed);
+            }
+            end_write();
+        }
+
+        // odd while a write is in progress, grows by 2 per write
+        uint64_t version() const { return sequence.load(std::memory_order_acquire); }
+
+    private:
+        template<auto N>
+        static size_t member_offset()
+        {
+            static const size_t offset = []()
+            {
+                alignas(T) static std::byte storage[sizeof(T)];
+                const T*                    object = reinterpret_cast<const T*>(storage);
+                return size_t(reinterpret_cast<const std::byte*>(&(object->*(getClassMemberPtr<T, N>()))) - storage);
+            }();
+            return offset;
+        }
+
+        void begin_write()
+        {
+            uint64_t current = sequence.load(std::memory_order_relaxed);
+            sequence.store(current + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void end_write() { sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+        template<class Copy>
+        void read_consistent(Copy&& copy) const
+        {
+            for(;;)
+            {
+                uint64_t before = sequence.load(std::memory_order_acquire);
+                if(before & 1)
+                    continue;
+                copy();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(sequence.load(std::memory_order_relaxed) == before)
+                    return;
+            }
+        }
+
+        // every word touching [begin, end), the bytes of a last partial word past sizeof(T) stay zero
+        void write_words(const T& value, size_t begin, size_t end)
+        {
+            const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+            for(size_t word = begin / sizeof(uint64_t); word * sizeof(uint64_t) < end; word++)
+            {
+                uint64_t bits       = 0;
+                size_t   word_begin = word * sizeof(uint64_t);
+                std::memcpy(&bits, bytes + word_begin, std::min(sizeof(uint64_t), sizeof(T) - word_begin));
+                words[word].store(bits, std::memory_order_relaxed);
+            }
+        }
+
+        void read_words(uint64_t* buffer, size_t begin, size_t end) const
+        {
+            for(size_t word = begin / sizeof(uint64_t); word * sizeof(uint64_t) < end; word++)
+                buffer[word] = words[word].load(std::memory_order_relaxed);
+        }
+
+        alignas(64) std::atomic<uint64_t> sequence{0};
+        std::array<std::atomic<uint64_t>, word_count> words{};
+    };
+} // namespace static_reflection_v2
+
+#endif /* SEQLOCKCELL_H */
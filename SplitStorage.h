@@ -0,0 +1,268 @@
+#ifndef SPLITSTORAGE_H
+#define SPLITSTORAGE_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    template<class FieldInfo>
+    constexpr bool is_hot_member()
+    {
+        if constexpr(is_member_ptr_tag<FieldInfo>())
+            return std::is_same_v<decltype(std::decay_t<FieldInfo>::tag), hot_tag>;
+        else
+            return false;
+    }
+
+    template<class FieldInfo, bool = is_member_ptr_group<FieldInfo>()>
+    struct split_member
+    {
+        using type = typename member_ptr_traits<std::decay_t<decltype(FieldInfo::ptr)>>::member_type;
+    };
+
+    // rejected by the static_assert of split_layout, keeps the errors down to that one
+    template<class FieldInfo>
+    struct split_member<FieldInfo, true>
+    {
+        using type = std::byte;
+    };
+
+    // which members of T go to the hot block, which to the cold one, and where each one sits
+    template<class T>
+    struct split_layout
+    {
+        using member_tuple = std::decay_t<decltype(getClassMetaInfo<T>().member_info_tuple)>;
+
+        static constexpr size_t size = std::tuple_size_v<member_tuple>;
+
+        template<size_t I>
+        using field_info_t = std::tuple_element_t<I, member_tuple>;
+
+        template<size_t I>
+        using member_t = typename split_member<field_info_t<I>>::type;
+
+        static_assert([]<size_t... I>(std::index_sequence<I...>) { return !(is_member_ptr_group<field_info_t<I>>() || ...); }(std::make_index_sequence<size>{}),
+                      "split_storage keeps one slot per member, META_MEMBER_BIND groups are not supported");
+        static_assert([]<size_t... I>(std::index_sequence<I...>) { return !(std::is_array_v<member_t<I>> || ...); }(std::make_index_sequence<size>{}),
+                      "split_storage copies members in and out, use std::array for array members");
+
+        static constexpr std::array<bool, size> hot = []<size_t... I>(std::index_sequence<I...>)
+        { return std::array<bool, size>{is_hot_member<field_info_t<I>>()...}; }(std::make_index_sequence<size>{});
+
+        static constexpr std::array<size_t, size> align = []<size_t... I>(std::index_sequence<I...>)
+        { return std::array<size_t, size>{alignof(member_t<I>)...}; }(std::make_index_sequence<size>{});
+
+        static constexpr size_t hot_count = []()
+        {
+            size_t count = 0;
+            for(bool is_hot: hot)
+                count += is_hot;
+            return count;
+        }();
+        static constexpr size_t cold_count = size - hot_count;
+
+        // member indices of one block, sorted by alignment, which keeps the padding inside the block down
+        template<size_t Count>
+        static constexpr std::array<size_t, Count> block_order(bool is_hot)
+        {
+            std::array<size_t, Count> order{};
+            size_t                    count = 0;
+            for(size_t i = 0; i < size; i++)
+            {
+                if(hot[i] != is_hot)
+                    continue;
+                size_t pos = count++;
+                for(; pos > 0 && align[order[pos - 1]] < align[i]; pos--)
+                    order[pos] = order[pos - 1];
+                order[pos] = i;
+            }
+            return order;
+        }
+
+        static constexpr std::array<size_t, hot_count>  hot_order  = block_order<hot_count>(true);
+        static constexpr std::array<size_t, cold_count> cold_order = block_order<cold_count>(false);
+
+        // position of member i in the tuple of its block
+        static constexpr std::array<size_t, size> slot = []()
+        {
+            std::array<size_t, size> table{};
+            for(size_t j = 0; j < hot_count; j++)
+                table[hot_order[j]] = j;
+            for(size_t j = 0; j < cold_count; j++)
+                table[cold_order[j]] = j;
+            return table;
+        }();
+
+        using hot_tuple = decltype([]<size_t... J>(std::index_sequence<J...>) { return std::tuple<member_t<hot_order[J]>...>{}; }(
+            std::make_index_sequence<hot_count>{}));
+        using cold_tuple = decltype([]<size_t... J>(std::index_sequence<J...>) { return std::tuple<member_t<cold_order[J]>...>{}; }(
+            std::make_index_sequence<cold_count>{}));
+    };
+
+    // the members of T split in two: META_MEMBER_HOT ones inline in a cache line aligned block,
+    // the rest in one heap block, both reached through get<N> / getClassMemberValueRef / FindInField
+    // split_storage<Session> session(loaded);
+    // get<0>(session) += 1;
+    template<class T>
+    class split_storage
+    {
+    public:
+        using value_type = T;
+        using layout     = split_layout<T>;
+        using hot_tuple  = typename layout::hot_tuple;
+        using cold_tuple = typename layout::cold_tuple;
+
+        static constexpr size_t hot_bytes  = sizeof(hot_tuple);
+        static constexpr size_t cold_bytes = layout::cold_count == 0 ? 0 : sizeof(cold_tuple);
+
+        split_storage()
+        {
+            if constexpr(layout::cold_count != 0)
+                block.cold = std::make_unique<cold_tuple>();
+        }
+
+        explicit split_storage(const T& value)
+            : split_storage()
+        {
+            load(value);
+        }
+
+        split_storage(const split_storage& other)
+        {
+            block.values = other.block.values;
+            if constexpr(layout::cold_count != 0)
+                block.cold = std::make_unique<cold_tuple>(*other.block.cold);
+        }
+
+        split_storage& operator=(const split_storage& other)
+        {
+            if(this != &other)
+            {
+                block.values = other.block.values;
+                if constexpr(layout::cold_count != 0)
+                    *block.cold = *other.block.cold;
+            }
+            return *this;
+        }
+
+        // a moved-from storage can only be assigned to or destroyed
+        split_storage(split_storage&&) noexcept            = default;
+        split_storage& operator=(split_storage&&) noexcept = default;
+
+        template<auto N>
+        auto& member()
+        {
+            if constexpr(layout::hot[N])
+                return std::get<layout::slot[N]>(block.values);
+            else
+                return std::get<layout::slot[N]>(*block.cold);
+        }
+
+        template<auto N>
+        const auto& member() const
+        {
+            if constexpr(layout::hot[N])
+                return std::get<layout::slot[N]>(block.values);
+            else
+                return std::get<layout::slot[N]>(*block.cold);
+        }
+
+        // every member copied in from value / out to value
+        void load(const T& value)
+        {
+            [this, &value]<size_t... I>(std::index_sequence<I...>)
+            { ((member<I>() = value.*(getClassMemberPtr<T, I>())), ...); }(std::make_index_sequence<layout::size>{});
+        }
+
+        void store(T& value) const
+        {
+            [this, &value]<size_t... I>(std::index_sequence<I...>)
+            { ((value.*(getClassMemberPtr<T, I>()) = member<I>()), ...); }(std::make_index_sequence<layout::size>{});
+        }
+
+        // fn(field_info, field, ...) for member idx, called like InvokeFieldFn calls it
+        template<class Storage, class Fn>
+        static bool visit(Storage& storage, size_t idx, Fn& fn)
+        {
+            using thunk_t = bool (*)(Storage&, Fn&);
+
+            constexpr auto jump_table = []<size_t... I>(std::index_sequence<I...>)
+            {
+                return std::array<thunk_t, layout::size>{[](Storage& storage, Fn& fn) -> bool
+                                                         {
+                                                             constexpr auto field_info = getClassMemberInfo<T, I>();
+                                                             auto&          field      = storage.template member<I>();
+                                                             if constexpr(is_member_ptr<decltype(field_info)>())
+                                                                 return fn(field_info, field);
+                                                             else if constexpr(is_member_ptr_tag<decltype(field_info)>())
+                                                                 return fn(field_info, field, field_info.tag);
+                                                             else
+                                                                 return fn(field_info, field, field_info.func);
+                                                         }...};
+            }(std::make_index_sequence<layout::size>{});
+
+            if(idx >= layout::size)
+                return false;
+            return jump_table[idx](storage, fn);
+        }
+
+    private:
+        // the cold pointer shares the line with the hot members, a small hot set makes the whole object one line
+        struct alignas(64) hot_block
+        {
+            hot_tuple                   values;
+            std::unique_ptr<cold_tuple> cold;
+        };
+
+        hot_block block;
+    };
+
+    template<auto N, class T>
+    auto& get(split_storage<T>& storage)
+    {
+        return storage.template member<N>();
+    }
+
+    template<auto N, class T>
+    const auto& get(const split_storage<T>& storage)
+    {
+        return storage.template member<N>();
+    }
+
+    template<class T, typename Fn>
+    inline bool getClassMemberValueRef(split_storage<T>& storage, size_t idx, Fn&& fn)
+    {
+        return split_storage<T>::visit(storage, idx, fn);
+    }
+
+    template<class T, typename Fn>
+    inline bool getClassMemberValueRef(const split_storage<T>& storage, size_t idx, Fn&& fn)
+    {
+        return split_storage<T>::visit(storage, idx, fn);
+    }
+
+    template<class T, typename Fn>
+    inline bool FindInField(split_storage<T>& storage, size_t field_hash, Fn&& fn)
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        size_t         index      = field_npos;
+        find_if_tuple_index(meta_class.member_info_tuple,
+                            [field_hash, &index](const auto& field_info, size_t idx) -> bool
+                            {
+                                if(field_info.field_name_hash != field_hash)
+                                    return false;
+                                index = idx;
+                                return true;
+                            });
+        return index != field_npos && split_storage<T>::visit(storage, index, fn);
+    }
+} // namespace static_reflection_v2
+
+#endif /* SPLITSTORAGE_H */
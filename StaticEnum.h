@@ -0,0 +1,162 @@
+#ifndef STATICENUM_H
+#define STATICENUM_H
+
+#include <array>
+#include <string_view>
+#include <type_traits>
+
+#include "PerfectHash.h"
+#include "StaticHash.h"
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    template<class T>
+    struct EnumValueInfo
+    {
+        const char* value_name;
+        size_t      value_name_hash;
+        T           value;
+    };
+
+    template<class T, size_t N>
+    struct EnumInfo
+    {
+        const char*                       enum_name;
+        std::array<EnumValueInfo<T>, N> value_info_array;
+    };
+
+    template<class T>
+    constexpr auto make_enum_value_info(const char* value_name, size_t value_name_hash, T value)
+    {
+        return EnumValueInfo<T>{value_name, value_name_hash, value};
+    }
+
+    template<class T, class... ValueInfo>
+    constexpr auto make_enum_info(const char* enum_name, ValueInfo&&... value_info)
+    {
+        return EnumInfo<T, sizeof...(ValueInfo)>{enum_name, {std::forward<ValueInfo>(value_info)...}};
+    }
+} // namespace static_reflection_v2
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+struct MetaEnum
+{
+    static inline constexpr void getMetaInfo() {}
+};
+
+#define DEFINE_ENUM_META(EnumT, ...)                                                                                   \
+    template<>                                                                                                         \
+    struct MetaEnum<EnumT>                                                                                             \
+    {                                                                                                                  \
+        using _ThisEnum = EnumT;                                                                                       \
+        template<typename E = void>                                                                                    \
+        static inline constexpr auto getMetaInfo()                                                                     \
+        {                                                                                                              \
+            return static_reflection_v2::make_enum_info<_ThisEnum>(#EnumT, __VA_ARGS__);                               \
+        }                                                                                                              \
+    };
+
+#define META_ENUM_VALUE(EnumValue) static_reflection_v2::make_enum_value_info(#EnumValue, #EnumValue##_HASH, _ThisEnum::EnumValue)
+#define META_ENUM_VALUE_NAME(EnumValue, ValueName) \
+    static_reflection_v2::make_enum_value_info(ValueName, ValueName##_HASH, _ThisEnum::EnumValue)
+
+template<typename T>
+using have_enum_meta_info = std::negation<std::is_same<decltype(MetaEnum<std::decay_t<T>>::getMetaInfo()), void>>;
+
+namespace static_reflection_v2
+{
+    template<class T>
+    struct EnumTable
+    {
+        using underlying_type = std::underlying_type_t<T>;
+
+        static constexpr auto   enum_info = MetaEnum<T>::getMetaInfo();
+        static constexpr size_t size      = enum_info.value_info_array.size();
+
+        static constexpr auto name_hash_table = []() constexpr
+        {
+            std::array<size_t, size> hashes{};
+            for(size_t i = 0; i < size; i++)
+                hashes[i] = enum_info.value_info_array[i].value_name_hash;
+            return make_perfect_hash(hashes);
+        }();
+
+        static constexpr underlying_type min_value = []() constexpr
+        {
+            underlying_type v = size ? underlying_type(enum_info.value_info_array[0].value) : 0;
+            for(const auto& info: enum_info.value_info_array)
+                v = underlying_type(info.value) < v ? underlying_type(info.value) : v;
+            return v;
+        }();
+
+        static constexpr underlying_type max_value = []() constexpr
+        {
+            underlying_type v = size ? underlying_type(enum_info.value_info_array[0].value) : 0;
+            for(const auto& info: enum_info.value_info_array)
+                v = underlying_type(info.value) > v ? underlying_type(info.value) : v;
+            return v;
+        }();
+
+        // value -> name indexed by (value - min_value), sparse enums fall back to a scan
+        static constexpr bool is_dense = size != 0 && uint64_t(int64_t(max_value) - int64_t(min_value)) < size * 4 + 16;
+
+        static constexpr auto value_name_array = []() constexpr
+        {
+            std::array<const char*, is_dense ? size_t(max_value - min_value) + 1 : 0> names{};
+            if constexpr(is_dense)
+            {
+                for(const auto& info: enum_info.value_info_array)
+                {
+                    auto& name = names[size_t(underlying_type(info.value) - min_value)];
+                    if(name == nullptr)
+                        name = info.value_name;
+                }
+            }
+            return names;
+        }();
+    };
+
+    template<class T>
+    constexpr bool enum_from_string(std::string_view value_name, T& value)
+    {
+        using table  = EnumTable<T>;
+        size_t index = table::name_hash_table.find(make_string_hash(value_name));
+        if(index == table::name_hash_table.npos)
+            return false;
+
+        // unknown names may still collide with a known hash
+        const auto& info = table::enum_info.value_info_array[index];
+        if(value_name != info.value_name)
+            return false;
+
+        value = info.value;
+        return true;
+    }
+
+    // nullptr if value is not a declared enumerator
+    template<class T>
+    constexpr const char* enum_to_string(T value)
+    {
+        using table = EnumTable<T>;
+        auto v      = std::underlying_type_t<T>(value);
+        if constexpr(table::is_dense)
+        {
+            if(v < table::min_value || v > table::max_value)
+                return nullptr;
+            return table::value_name_array[size_t(v - table::min_value)];
+        }
+        else
+        {
+            for(const auto& info: table::enum_info.value_info_array)
+            {
+                if(info.value == value)
+                    return info.value_name;
+            }
+            return nullptr;
+        }
+    }
+} // namespace static_reflection_v2
+
+#endif /* STATICENUM_H */
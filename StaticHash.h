@@ -1,6 +1,7 @@
 #ifndef STATICHASH_H
 #define STATICHASH_H
 
+#include <cstddef>
 #include <cstdint>
 
 namespace hash
@@ -324,4 +325,69 @@ namespace hash
     };
 }; // namespace hash
 
+namespace hash
+{
+    // name hash policies: hash(s, n) runs at compile time on the reflected names and at runtime on the keys
+    // the same policy has to be used on both sides, see DEFINE_META_HASH
+    struct murmur3_policy
+    {
+        using value_type = uint32_t;
+        static constexpr value_type hash(const char* s, size_t n) { return MurmurHash3::shash(s, n, 0); }
+    };
+
+    struct xxh32_policy
+    {
+        using value_type = uint32_t;
+        static constexpr value_type hash(const char* s, size_t n) { return xxh32::hash(s, uint32_t(n), 0); }
+    };
+
+    struct xxh64_policy
+    {
+        using value_type = uint64_t;
+        static constexpr value_type hash(const char* s, size_t n) { return xxh64::hash(s, n, 0); }
+    };
+
+    // same values as fnv1a(s) / djb2a(s) / crc32(s), but bounded by n instead of '\0'
+    struct fnv1a_policy
+    {
+        using value_type = uint32_t;
+        static constexpr value_type hash(const char* s, size_t n)
+        {
+            uint32_t h = 0x811C9DC5;
+            for(size_t i = 0; i < n; i++)
+                h = (h ^ (uint8_t)s[i]) * 0x01000193;
+            return h;
+        }
+    };
+
+    struct djb2a_policy
+    {
+        using value_type = uint32_t;
+        static constexpr value_type hash(const char* s, size_t n)
+        {
+            uint32_t h = 5381;
+            for(size_t i = 0; i < n; i++)
+                h = 33 * h ^ (uint8_t)s[i];
+            return h;
+        }
+    };
+
+    struct crc32_policy
+    {
+        using value_type = uint32_t;
+        static constexpr value_type hash(const char* s, size_t n)
+        {
+            uint32_t h = ~0;
+            for(size_t i = 0; i < n; i++)
+            {
+                h = CRC32_TABLE[(h & 0xF) ^ ((uint8_t)s[i] & 0xF)] ^ (h >> 4);
+                h = CRC32_TABLE[(h & 0xF) ^ ((uint8_t)s[i] >> 4)] ^ (h >> 4);
+            }
+            return ~h;
+        }
+    };
+
+    using default_policy = murmur3_policy;
+}; // namespace hash
+
 #endif /* STATICHASH_H */
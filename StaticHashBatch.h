@@ -0,0 +1,151 @@
+#ifndef STATICHASHBATCH_H
+#define STATICHASHBATCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#include "StaticHash.h"
+
+namespace hash
+{
+    namespace MurmurHash3
+    {
+        // the same k as body() / tail(), chars included with their sign, so the results match _HASH
+        inline uint32_t block(const char* s)
+        {
+            return s[0] | (s[1] << 8) | (s[2] << 16) | (s[3] << 24);
+        }
+
+        inline uint32_t tail_block(const char* s, size_t n)
+        {
+            return n == 3 ? s[0] | (s[1] << 8) | (s[2] << 16) : n == 2 ? s[0] | (s[1] << 8) : n == 1 ? s[0] : 0;
+        }
+
+#if defined(__AVX2__)
+        using lane_t                       = __m256i;
+        static constexpr size_t lane_count = 8;
+
+        inline lane_t lane_load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        inline void   lane_store(uint32_t* p, lane_t x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+        inline lane_t lane_set(uint32_t x) { return _mm256_set1_epi32(int(x)); }
+        template<class Fn>
+        inline lane_t lane_make(Fn&& fn) { return _mm256_setr_epi32(fn(0), fn(1), fn(2), fn(3), fn(4), fn(5), fn(6), fn(7)); }
+        inline lane_t lane_mul(lane_t x, lane_t y) { return _mm256_mullo_epi32(x, y); }
+        inline lane_t lane_add(lane_t x, lane_t y) { return _mm256_add_epi32(x, y); }
+        inline lane_t lane_xor(lane_t x, lane_t y) { return _mm256_xor_si256(x, y); }
+        inline lane_t lane_and(lane_t x, lane_t y) { return _mm256_and_si256(x, y); }
+        inline lane_t lane_or(lane_t x, lane_t y) { return _mm256_or_si256(x, y); }
+        inline lane_t lane_greater(lane_t x, lane_t y) { return _mm256_cmpgt_epi32(x, y); }
+        inline lane_t lane_select(lane_t mask, lane_t x, lane_t y) { return _mm256_blendv_epi8(y, x, mask); }
+        template<int r>
+        inline lane_t lane_rotl(lane_t x) { return _mm256_or_si256(_mm256_slli_epi32(x, r), _mm256_srli_epi32(x, 32 - r)); }
+        template<int r>
+        inline lane_t lane_shlxor(lane_t x) { return _mm256_xor_si256(_mm256_srli_epi32(x, r), x); }
+        // all ones where bit 7 of byte B is set
+        template<int B>
+        inline lane_t lane_byte_sign(lane_t x) { return _mm256_srai_epi32(_mm256_slli_epi32(x, 24 - B * 8), 31); }
+#elif defined(__SSE4_1__)
+        using lane_t                       = __m128i;
+        static constexpr size_t lane_count = 4;
+
+        inline lane_t lane_load(const uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        inline void   lane_store(uint32_t* p, lane_t x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+        inline lane_t lane_set(uint32_t x) { return _mm_set1_epi32(int(x)); }
+        template<class Fn>
+        inline lane_t lane_make(Fn&& fn) { return _mm_setr_epi32(fn(0), fn(1), fn(2), fn(3)); }
+        inline lane_t lane_mul(lane_t x, lane_t y) { return _mm_mullo_epi32(x, y); }
+        inline lane_t lane_add(lane_t x, lane_t y) { return _mm_add_epi32(x, y); }
+        inline lane_t lane_xor(lane_t x, lane_t y) { return _mm_xor_si128(x, y); }
+        inline lane_t lane_and(lane_t x, lane_t y) { return _mm_and_si128(x, y); }
+        inline lane_t lane_or(lane_t x, lane_t y) { return _mm_or_si128(x, y); }
+        inline lane_t lane_greater(lane_t x, lane_t y) { return _mm_cmpgt_epi32(x, y); }
+        inline lane_t lane_select(lane_t mask, lane_t x, lane_t y) { return _mm_blendv_epi8(y, x, mask); }
+        template<int r>
+        inline lane_t lane_rotl(lane_t x) { return _mm_or_si128(_mm_slli_epi32(x, r), _mm_srli_epi32(x, 32 - r)); }
+        template<int r>
+        inline lane_t lane_shlxor(lane_t x) { return _mm_xor_si128(_mm_srli_epi32(x, r), x); }
+        // all ones where bit 7 of byte B is set
+        template<int B>
+        inline lane_t lane_byte_sign(lane_t x) { return _mm_srai_epi32(_mm_slli_epi32(x, 24 - B * 8), 31); }
+#endif
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+        inline lane_t lane_kmix(lane_t k) { return lane_mul(lane_rotl<15>(lane_mul(k, lane_set(0xCC9E2D51))), lane_set(0x1B873593)); }
+
+        inline lane_t lane_hmix(lane_t h, lane_t k)
+        {
+            return lane_add(lane_mul(lane_rotl<13>(lane_xor(h, lane_kmix(k))), lane_set(5)), lane_set(0xE6546B64));
+        }
+
+        inline lane_t lane_fmix(lane_t h)
+        {
+            return lane_shlxor<16>(lane_mul(lane_shlxor<13>(lane_mul(lane_shlxor<16>(h), lane_set(0x85EBCA6B))), lane_set(0xC2B2AE35)));
+        }
+
+        // little endian words to block(): a char with bit 7 set is sign extended over the bytes above it
+        inline lane_t lane_block(lane_t w)
+        {
+            lane_t sign = lane_and(lane_byte_sign<0>(w), lane_set(0xFFFFFF00));
+            sign        = lane_or(sign, lane_and(lane_byte_sign<1>(w), lane_set(0xFFFF0000)));
+            sign        = lane_or(sign, lane_and(lane_byte_sign<2>(w), lane_set(0xFF000000)));
+            return lane_or(w, sign);
+        }
+
+        // one key per lane, a lane stops mixing once its blocks run out
+        inline void shash_lanes(const std::string_view* keys, uint32_t* out)
+        {
+            static constexpr char zero_block[4] = {};
+
+            size_t max_size = 0;
+            for(size_t i = 0; i < lane_count; i++)
+                max_size = std::max(max_size, keys[i].size());
+
+            lane_t h      = lane_set(0);
+            lane_t n      = lane_make([keys](size_t i) { return int(keys[i].size()); });
+            lane_t blocks = lane_xor(n, lane_and(n, lane_set(3)));
+            for(size_t pos = 0; pos + 4 <= max_size; pos += 4)
+            {
+                // a finished lane reads zero_block, so the loads stay branch free and in bounds
+                lane_t k = lane_make(
+                    [keys, pos](size_t i)
+                    {
+                        int word;
+                        std::memcpy(&word, pos + 4 <= keys[i].size() ? keys[i].data() + pos : zero_block, 4);
+                        return word;
+                    });
+
+                lane_t active = lane_greater(blocks, lane_set(uint32_t(pos)));
+                h             = lane_select(active, lane_hmix(h, lane_block(k)), h);
+            }
+
+            lane_t k = lane_make([keys](size_t i) { return int(tail_block(keys[i].data() + (keys[i].size() & ~size_t(3)), keys[i].size() & 3)); });
+            h        = lane_fmix(lane_xor(lane_xor(h, lane_kmix(k)), n));
+            lane_store(out, h);
+        }
+#endif
+    } // namespace MurmurHash3
+
+    // out[i] = "keys[i]"_HASH, for min(keys.size(), out.size()) keys
+    // 8 keys at a time with AVX2, 4 with SSE4.1, the remainder and other targets go through shash
+    inline void hash_many(std::span<const std::string_view> keys, std::span<uint32_t> out)
+    {
+        size_t count = std::min(keys.size(), out.size());
+        size_t i     = 0;
+#if defined(__AVX2__) || defined(__SSE4_1__)
+        for(; i + MurmurHash3::lane_count <= count; i += MurmurHash3::lane_count)
+            MurmurHash3::shash_lanes(keys.data() + i, out.data() + i);
+#endif
+        for(; i < count; i++)
+            out[i] = MurmurHash3::shash(keys[i].data(), keys[i].size(), 0);
+    }
+}; // namespace hash
+
+#endif /* STATICHASHBATCH_H */
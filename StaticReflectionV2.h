@@ -1,6 +1,11 @@
 #ifndef STATICREFLECTIONV2_H
 #define STATICREFLECTIONV2_H
 
+#include <bitset>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -8,6 +13,10 @@
 #include "StaticHash.h"
 #include "TupleHelper.h"
 
+#ifdef STATIC_REFLECTION_ENABLE_STATS
+#include "ReflectStats.h"
+#endif
+
 namespace static_reflection_v2
 {
 
@@ -16,9 +25,20 @@ namespace static_reflection_v2
         MemberPtr,
         MemberPtrInfoTag,
         MemberPtrInfoFunc,
+        MemberPtrGroup,
         FuncInfo
     };
 
+    // tag of META_MEMBER_HOT
+    struct hot_tag
+    {
+    };
+
+    // tag of META_MEMBER_INTERN
+    struct intern_tag
+    {
+    };
+
     template<class T, FieldType field_type>
     struct FieldInfo
     {
@@ -46,6 +66,13 @@ namespace static_reflection_v2
         Func func;
     };
 
+    // one name bound to several members, bind_tuple holds MemberPtrInfo / MemberPtrInfoTag / MemberPtrInfoFunc
+    template<class T, class BindTuple>
+    struct MemberPtrGroupInfo : public FieldInfo<T, FieldType::MemberPtrGroup>
+    {
+        BindTuple bind_tuple;
+    };
+
     template<class T, class member_func_ptr>
     struct FuncInfo : public FieldInfo<T, FieldType::FuncInfo>
     {
@@ -87,6 +114,22 @@ namespace static_reflection_v2
         };
     }
 
+    // every bind takes the name and hash of the group
+    template<class T, class... Binds>
+    constexpr auto make_member_ptr_group(const char* field_name, size_t field_name_hash, Binds... binds)
+    {
+        auto rename = [field_name, field_name_hash](auto bind) constexpr
+        {
+            bind.field_name      = field_name;
+            bind.field_name_hash = field_name_hash;
+            return bind;
+        };
+        return MemberPtrGroupInfo<T, std::tuple<Binds...>>{
+            {field_name, field_name_hash},
+            std::make_tuple(rename(binds)...)
+        };
+    }
+
     template<class T, class C>
     constexpr auto make_func_info(const char* field_name, size_t field_name_hash, C T::*func_ptr)
     {
@@ -108,6 +151,45 @@ namespace static_reflection_v2
         return ClassInfo<T, MemberTuple, std::tuple<>>{class_name, std::forward<MemberTuple>(member_tuple)};
     }
 
+    template<class MemberPtr>
+    struct member_ptr_traits;
+
+    template<class T, class C>
+    struct member_ptr_traits<C T::*>
+    {
+        using class_type  = T;
+        using member_type = C;
+    };
+
+    // base member function pointers are kept as is, derived.*ptr still works with them
+    // and the base-to-derived conversion is not a constant expression on every compiler
+    template<class T, class Base, class C>
+    constexpr auto rebase_member_ptr(C Base::*ptr)
+    {
+        if constexpr(std::is_member_function_pointer_v<C Base::*>)
+            return ptr;
+        else
+            return static_cast<C T::*>(ptr);
+    }
+
+    // FieldInfo of a base class, re-typed as a FieldInfo of T
+    template<class T, class FieldInfo>
+    constexpr auto rebase_field_info(const FieldInfo& field_info);
+
+    template<class T, class BaseClassInfo, class ClassInfo>
+    constexpr auto make_derived_class_info(const BaseClassInfo& base_class_info, const ClassInfo& class_info)
+    {
+        auto rebase_tuple = [](const auto& info_tuple) constexpr
+        {
+            return std::apply([](const auto&... field_info) constexpr { return std::make_tuple(rebase_field_info<T>(field_info)...); },
+                              info_tuple);
+        };
+
+        auto member_tuple = std::tuple_cat(rebase_tuple(base_class_info.member_info_tuple), class_info.member_info_tuple);
+        auto func_tuple   = std::tuple_cat(rebase_tuple(base_class_info.func_info_tuple), class_info.func_info_tuple);
+        return make_class_info<T>(class_info.class_name, std::move(member_tuple), std::move(func_tuple));
+    }
+
     template<class FieldInfo>
     constexpr bool is_member_ptr()
     {
@@ -126,34 +208,120 @@ namespace static_reflection_v2
         return std::decay_t<FieldInfo>::this_field_type == FieldType::MemberPtrInfoFunc;
     }
 
+    template<class FieldInfo>
+    constexpr bool is_member_ptr_group()
+    {
+        return std::decay_t<FieldInfo>::this_field_type == FieldType::MemberPtrGroup;
+    }
+
     template<class FieldInfo>
     constexpr bool is_member_func()
     {
         return std::decay_t<FieldInfo>::this_field_type == FieldType::FuncInfo;
     }
+
+    // fn(member_field_info) for every member a FieldInfo writes: itself, each bind of a group, none for a function
+    template<class FieldInfo, class Fn>
+    constexpr void for_each_member_bind(const FieldInfo& field_info, Fn&& fn)
+    {
+        if constexpr(is_member_ptr_group<FieldInfo>())
+            for_each_tuple(field_info.bind_tuple, fn);
+        else if constexpr(!is_member_func<FieldInfo>())
+            fn(field_info);
+    }
+
+    template<class T, class FieldInfo>
+    constexpr auto rebase_field_ptr_info(const FieldInfo& field_info)
+    {
+        auto ptr = rebase_member_ptr<T>(field_info.ptr);
+        if constexpr(is_member_ptr<FieldInfo>())
+        {
+            return MemberPtrInfo<T, decltype(ptr)>{{field_info.field_name, field_info.field_name_hash}, ptr};
+        }
+        else if constexpr(is_member_ptr_tag<FieldInfo>())
+        {
+            return MemberPtrInfoTag<T, decltype(ptr), decltype(field_info.tag)>{
+                {{field_info.field_name, field_info.field_name_hash}, ptr},
+                field_info.tag
+            };
+        }
+        else if constexpr(is_member_ptr_func<FieldInfo>())
+        {
+            return MemberPtrInfoFunc<T, decltype(ptr), decltype(field_info.func)>{
+                {{field_info.field_name, field_info.field_name_hash}, ptr},
+                field_info.func
+            };
+        }
+        else
+        {
+            return FuncInfo<T, decltype(ptr)>{{field_info.field_name, field_info.field_name_hash}, ptr};
+        }
+    }
+
+    template<class T, class FieldInfo>
+    constexpr auto rebase_field_info(const FieldInfo& field_info)
+    {
+        if constexpr(is_member_ptr_group<FieldInfo>())
+        {
+            return std::apply([&field_info](const auto&... bind) constexpr
+                              { return make_member_ptr_group<T>(field_info.field_name, field_info.field_name_hash, rebase_field_info<T>(bind)...); },
+                              field_info.bind_tuple);
+        }
+        else
+        {
+            return rebase_field_ptr_info<T>(field_info);
+        }
+    }
 }; // namespace static_reflection_v2
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename T>
 struct MetaClass
 {
+    using _HashPolicy = hash::default_policy;
     static inline constexpr void getMetaInfo() {}
 };
 
 #define DEFINE_MEMBER(...)   std::make_tuple(__VA_ARGS__)
 #define DEFINE_FUNCTION(...) std::make_tuple(__VA_ARGS__)
 
-#define DEFINE_META(ClassT, ...)                                                                                       \
+#define DEFINE_META(ClassT, ...) DEFINE_META_HASH(ClassT, ::hash::default_policy, __VA_ARGS__)
+
+// HashPolicy from StaticHash.h hashes the member names, make_string_hash<ClassT>() hashes runtime keys the same way
+#define DEFINE_META_HASH(ClassT, HashPolicy, ...)                                                                      \
     template<>                                                                                                         \
     struct MetaClass<ClassT>                                                                                           \
     {                                                                                                                  \
-        using _ThisClass = ClassT;                                                                                     \
+        using _ThisClass  = ClassT;                                                                                    \
+        using _HashPolicy = HashPolicy;                                                                                \
         template<typename E = void>                                                                                    \
         static inline constexpr auto getMetaInfo()                                                                     \
         {                                                                                                              \
             return static_reflection_v2::make_class_info<_ThisClass>(#ClassT, __VA_ARGS__);                            \
         }                                                                                                              \
     };                                                                                                                 \
+    DEFINE_META_TUPLE_INTERFACE(ClassT)
+
+// BaseT must have its own DEFINE_META, its members and functions come first in the flattened tuples
+// the hash policy of BaseT is kept, so the flattened hashes all agree
+#define DEFINE_META_DERIVED(ClassT, BaseT, ...)                                                                        \
+    template<>                                                                                                         \
+    struct MetaClass<ClassT>                                                                                           \
+    {                                                                                                                  \
+        using _ThisClass  = ClassT;                                                                                    \
+        using _BaseClass  = BaseT;                                                                                     \
+        using _HashPolicy = typename MetaClass<BaseT>::_HashPolicy;                                                    \
+        template<typename E = void>                                                                                    \
+        static inline constexpr auto getMetaInfo()                                                                     \
+        {                                                                                                              \
+            return static_reflection_v2::make_derived_class_info<_ThisClass>(                                          \
+                MetaClass<_BaseClass>::getMetaInfo(),                                                                  \
+                static_reflection_v2::make_class_info<_ThisClass>(#ClassT, __VA_ARGS__));                              \
+        }                                                                                                              \
+    };                                                                                                                 \
+    DEFINE_META_TUPLE_INTERFACE(ClassT)
+
+#define DEFINE_META_TUPLE_INTERFACE(ClassT)                                                                            \
     template<auto N>                                                                                                   \
     const auto& get(const ClassT& f)                                                                                   \
     {                                                                                                                  \
@@ -173,23 +341,41 @@ struct MetaClass
         };                                                                                                             \
     } // namespace std
 
-#define META_MEMBER(ClassField) static_reflection_v2::make_member_ptr(#ClassField, #ClassField##_HASH, &_ThisClass::ClassField)
+// FieldName is a string literal, hashed by the policy of the enclosing DEFINE_META_HASH
+#define META_NAME_HASH(FieldName) _HashPolicy::hash(FieldName, sizeof(FieldName) - 1)
+
+#define META_MEMBER(ClassField) static_reflection_v2::make_member_ptr(#ClassField, META_NAME_HASH(#ClassField), &_ThisClass::ClassField)
 #define META_MEMBER_TAG(ClassField, Tag) \
-    static_reflection_v2::make_member_ptr_tag(#ClassField, #ClassField##_HASH, &_ThisClass::ClassField, Tag{})
+    static_reflection_v2::make_member_ptr_tag(#ClassField, META_NAME_HASH(#ClassField), &_ThisClass::ClassField, Tag{})
 #define META_MEMBER_FUNC(ClassField, Func) \
-    static_reflection_v2::make_member_ptr_func(#ClassField, #ClassField##_HASH, &_ThisClass::ClassField, Func)
+    static_reflection_v2::make_member_ptr_func(#ClassField, META_NAME_HASH(#ClassField), &_ThisClass::ClassField, Func)
 
-#define META_MEMBER_NAME(ClassField, FieldName) static_reflection_v2::make_member_ptr(FieldName, FieldName##_HASH, &_ThisClass::ClassField)
+#define META_MEMBER_NAME(ClassField, FieldName) static_reflection_v2::make_member_ptr(FieldName, META_NAME_HASH(FieldName), &_ThisClass::ClassField)
 #define META_MEMBER_NAME_TAG(ClassField, FieldName, Tag) \
-    static_reflection_v2::make_member_ptr_tag(FieldName, FieldName##_HASH, &_ThisClass::ClassField, Tag{})
+    static_reflection_v2::make_member_ptr_tag(FieldName, META_NAME_HASH(FieldName), &_ThisClass::ClassField, Tag{})
 #define META_MEMBER_NAME_FUNC(ClassField, FieldName, Func) \
-    static_reflection_v2::make_member_ptr_func(FieldName, FieldName##_HASH, &_ThisClass::ClassField, Func)
+    static_reflection_v2::make_member_ptr_func(FieldName, META_NAME_HASH(FieldName), &_ThisClass::ClassField, Func)
+
+// touched on every request, split_storage keeps these in its inline block
+#define META_MEMBER_HOT(ClassField)                  META_MEMBER_TAG(ClassField, static_reflection_v2::hot_tag)
+#define META_MEMBER_NAME_HOT(ClassField, FieldName) META_MEMBER_NAME_TAG(ClassField, FieldName, static_reflection_v2::hot_tag)
+
+// a std::string_view member the loaders point into the shared string pool, see StringPool.h
+#define META_MEMBER_INTERN(ClassField)                  META_MEMBER_TAG(ClassField, static_reflection_v2::intern_tag)
+#define META_MEMBER_NAME_INTERN(ClassField, FieldName) META_MEMBER_NAME_TAG(ClassField, FieldName, static_reflection_v2::intern_tag)
+
+// META_MEMBER_BIND("breakTime", META_BIND(iWaitTimeQianYao), META_BIND_TAG(iWaitTimeMoveQianYao, Tag))
+#define META_MEMBER_BIND(FieldName, ...) \
+    static_reflection_v2::make_member_ptr_group<_ThisClass>(FieldName, META_NAME_HASH(FieldName), __VA_ARGS__)
+#define META_BIND(ClassField)            static_reflection_v2::make_member_ptr(#ClassField, 0, &_ThisClass::ClassField)
+#define META_BIND_TAG(ClassField, Tag)   static_reflection_v2::make_member_ptr_tag(#ClassField, 0, &_ThisClass::ClassField, Tag{})
+#define META_BIND_FUNC(ClassField, Func) static_reflection_v2::make_member_ptr_func(#ClassField, 0, &_ThisClass::ClassField, Func)
 
-#define META_FUNCTION(ClassField) static_reflection_v2::make_func_info(#ClassField, #ClassField##_HASH, &_ThisClass::ClassField)
-#define META_FUNCTION_NAME(ClassField, FieldName) static_reflection_v2::make_func_info(FieldName, FieldName##_HASH, &_ThisClass::ClassField)
+#define META_FUNCTION(ClassField) static_reflection_v2::make_func_info(#ClassField, META_NAME_HASH(#ClassField), &_ThisClass::ClassField)
+#define META_FUNCTION_NAME(ClassField, FieldName) static_reflection_v2::make_func_info(FieldName, META_NAME_HASH(FieldName), &_ThisClass::ClassField)
 
 template<typename T>
-using not_have_meta_info = std::is_same<std::invoke_result_t<decltype(&MetaClass<std::decay_t<T>>::getMetaInfo)>, void>;
+using not_have_meta_info = std::is_same<decltype(MetaClass<std::decay_t<T>>::getMetaInfo()), void>;
 
 template<typename T>
 using have_meta_info = std::negation<not_have_meta_info<T>>;
@@ -260,7 +446,7 @@ namespace static_reflection_v2
     {
         constexpr auto meta_class = getClassMetaInfo<T>();
         size_t         index      = 0;
-        find_if_tuple(meta_class.member_info_tuple,
+        find_if_tuple_index(meta_class.member_info_tuple,
                       [field_hash, &index](const auto& field_info, size_t idx) constexpr -> bool
                       {
                           if(field_info.field_name_hash != field_hash)
@@ -271,15 +457,28 @@ namespace static_reflection_v2
                               index = idx;
                               return true;
                           }
+                          return false;
                       });
 
         return index;
     }
-#define GET_CLASS_MEMBER_INDEX(ClassT, FieldName) static_reflection_v2::getClassMemberIndex<ClassT>(FieldName##_HASH)
+#define GET_CLASS_MEMBER_INDEX(ClassT, FieldName) \
+    static_reflection_v2::getClassMemberIndex<ClassT>(static_reflection_v2::make_string_hash<ClassT>(FieldName))
+
+    // default policy, class names and enum value names use it
+    constexpr size_t make_string_hash(std::string_view str)
+    {
+        return hash::default_policy::hash(str.data(), str.size());
+    }
+
+    template<class T>
+    using class_hash_policy_t = typename MetaClass<std::decay_t<T>>::_HashPolicy;
 
-    static size_t make_string_hash(const std::string& str)
+    // a runtime key hashed like the member names of T, for FindInField
+    template<class T>
+    constexpr size_t make_string_hash(std::string_view str)
     {
-        return hash::MurmurHash3::shash(str.c_str(), str.size(), 0);
+        return class_hash_policy_t<T>::hash(str.data(), str.size());
     }
 
 } // end namespace static_reflection_v2
@@ -296,49 +495,304 @@ namespace static_reflection_v2
         for_each_tuple(meta_class.member_info_tuple,
                        [&fn, &value](const auto& field_info) constexpr
                        {
-                           if constexpr(is_member_ptr<decltype(field_info)>())
-                           {
-                               fn(field_info, value.*(field_info.ptr));
-                           }
-                           else if constexpr(is_member_ptr_tag<decltype(field_info)>())
-                           {
-                               fn(field_info, value.*(field_info.ptr), field_info.tag);
-                           }
-                           else if constexpr(is_member_ptr_func<decltype(field_info)>())
-                           {
-                               field_info.func(field_info, value.*(field_info.ptr));
-                           }
+                           for_each_member_bind(field_info,
+                                                [&fn, &value](const auto& bind_info) constexpr
+                                                {
+                                                    if constexpr(is_member_ptr<decltype(bind_info)>())
+                                                    {
+                                                        fn(bind_info, value.*(bind_info.ptr));
+                                                    }
+                                                    else if constexpr(is_member_ptr_tag<decltype(bind_info)>())
+                                                    {
+                                                        fn(bind_info, value.*(bind_info.ptr), bind_info.tag);
+                                                    }
+                                                    else if constexpr(is_member_ptr_func<decltype(bind_info)>())
+                                                    {
+                                                        bind_info.func(bind_info, value.*(bind_info.ptr));
+                                                    }
+                                                });
                        });
     }
 
+    // one member across a span of objects: element i is objects[i].*ptr, sizeof(T) bytes apart
+    template<class FieldType>
+    class strided_range
+    {
+        using byte_type = std::conditional_t<std::is_const_v<FieldType>, const std::byte, std::byte>;
+
+    public:
+        // elements this far ahead are prefetched by for_each once they sit on different cache lines
+        static constexpr size_t prefetch_distance = 8;
+
+        class iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = std::remove_cv_t<FieldType>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = FieldType*;
+            using reference         = FieldType&;
+
+            iterator() = default;
+            iterator(byte_type* pos, size_t stride) : pos(pos), stride(stride) {}
+
+            reference operator*() const { return *reinterpret_cast<pointer>(pos); }
+            pointer   operator->() const { return reinterpret_cast<pointer>(pos); }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            iterator& operator++() { pos += stride; return *this; }
+            iterator  operator++(int) { iterator it = *this; pos += stride; return it; }
+            iterator& operator--() { pos -= stride; return *this; }
+            iterator  operator--(int) { iterator it = *this; pos -= stride; return it; }
+            iterator& operator+=(difference_type n) { pos += n * difference_type(stride); return *this; }
+            iterator& operator-=(difference_type n) { pos -= n * difference_type(stride); return *this; }
+
+            friend iterator        operator+(iterator it, difference_type n) { return it += n; }
+            friend iterator        operator+(difference_type n, iterator it) { return it += n; }
+            friend iterator        operator-(iterator it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const iterator& x, const iterator& y) { return (x.pos - y.pos) / difference_type(x.stride); }
+            friend bool            operator==(const iterator& x, const iterator& y) { return x.pos == y.pos; }
+            friend auto            operator<=>(const iterator& x, const iterator& y) { return x.pos <=> y.pos; }
+
+        private:
+            byte_type* pos    = nullptr;
+            size_t     stride = 0;
+        };
+
+        strided_range(FieldType* first, size_t stride, size_t count)
+            : first(reinterpret_cast<byte_type*>(first))
+            , stride(stride)
+            , count(count)
+        {
+        }
+
+        size_t     size() const { return count; }
+        bool       empty() const { return count == 0; }
+        FieldType& operator[](size_t i) const { return *reinterpret_cast<FieldType*>(first + i * stride); }
+        iterator   begin() const { return iterator(first, stride); }
+        iterator   end() const { return iterator(first + count * stride, stride); }
+
+        // fn(element) front to back, the loop the compiler sees is the whole batch
+        template<class Fn>
+        void for_each(Fn&& fn) const
+        {
+            size_t i = 0;
+#if defined(__GNUC__) || defined(__clang__)
+            if(stride >= 64)
+            {
+                for(; i + prefetch_distance < count; i++)
+                {
+                    __builtin_prefetch(first + (i + prefetch_distance) * stride, std::is_const_v<FieldType> ? 0 : 1);
+                    fn((*this)[i]);
+                }
+            }
+#endif
+            for(; i < count; i++)
+                fn((*this)[i]);
+        }
+
+    private:
+        byte_type* first;
+        size_t     stride;
+        size_t     count;
+    };
+
+    // ForEachField turned inside out: fn(field_info, strided_range) once per member, for the whole span
+    // fn(field_info, range, tag) for tagged members; a func member gets func(field_info, field) for every element
     template<typename T, typename Fn>
-    inline constexpr void FindInField(T&& value, size_t field_hash, Fn&& fn)
+    inline void ForEachFieldBatch(std::span<T> values, Fn&& fn)
     {
         constexpr auto meta_class = getClassMetaInfo<T>();
         static_assert(getClassMemberSize<T>() != 0,
                       "MetaClass<T>() for type T should be specialized to return "
                       "FieldSchema tuples, like ((&T::field, field_name), ...)");
+        if(values.empty())
+            return;
+
+        for_each_tuple(meta_class.member_info_tuple,
+                       [&fn, values](const auto& field_info)
+                       {
+                           for_each_member_bind(field_info,
+                                                [&fn, values](const auto& bind_info)
+                                                {
+                                                    using field_t = std::remove_reference_t<decltype(values[0].*(bind_info.ptr))>;
+                                                    strided_range<field_t> range(&(values[0].*(bind_info.ptr)), sizeof(T), values.size());
+                                                    if constexpr(is_member_ptr<decltype(bind_info)>())
+                                                    {
+                                                        fn(bind_info, range);
+                                                    }
+                                                    else if constexpr(is_member_ptr_tag<decltype(bind_info)>())
+                                                    {
+                                                        fn(bind_info, range, bind_info.tag);
+                                                    }
+                                                    else if constexpr(is_member_ptr_func<decltype(bind_info)>())
+                                                    {
+                                                        range.for_each([&bind_info](auto& field) { bind_info.func(bind_info, field); });
+                                                    }
+                                                });
+                       });
+    }
+
+    template<typename T, typename FieldInfo, typename Fn>
+    inline constexpr bool InvokeFieldFn(T&& value, const FieldInfo& field_info, Fn&& fn)
+    {
+        if constexpr(is_member_ptr<FieldInfo>())
+        {
+            return fn(field_info, value.*(field_info.ptr));
+        }
+        else if constexpr(is_member_ptr_tag<FieldInfo>())
+        {
+            return fn(field_info, value.*(field_info.ptr), field_info.tag);
+        }
+        else if constexpr(is_member_ptr_func<FieldInfo>())
+        {
+            return fn(field_info, value.*(field_info.ptr), field_info.func);
+        }
+        else if constexpr(is_member_ptr_group<FieldInfo>())
+        {
+            // one hash check fans out to every bound member, all of them run before the results are combined
+            bool result = false;
+            for_each_tuple(field_info.bind_tuple,
+                           [&fn, &value, &result](const auto& bind_info) constexpr { result = InvokeFieldFn(value, bind_info, fn) || result; });
+            return result;
+        }
+
+        return false;
+    }
+
+    // runtime index into member_info_tuple, e.g. from GET_CLASS_MEMBER_INDEX or a perfect hash slot
+    // fn is called like FindInField does, false if idx is out of range or names a member function
+    template<typename T, typename Fn>
+    inline constexpr bool getClassMemberValueRef(T&& value, size_t idx, Fn&& fn)
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        if(idx >= getClassMemberSize<T>())
+            return false;
+
+        return visit_tuple_at(meta_class.member_info_tuple,
+                              idx,
+                              [&fn, &value](const auto& field_info) constexpr -> bool { return InvokeFieldFn(value, field_info, fn); });
+    }
+
+    // no field has the hash
+    inline constexpr size_t field_npos = size_t(-1);
+    // fields have the hash, fn returned false for each of them
+    inline constexpr size_t field_rejected = size_t(-2);
+
+    inline constexpr bool field_found(size_t index)
+    {
+        return index != field_npos && index != field_rejected;
+    }
+
+    // index in member_info_tuple of the field that matched field_hash and whose fn returned true,
+    // field_rejected if fn returned false for every match, field_npos without a match
+    template<typename T, typename Fn>
+    inline constexpr size_t FindInFieldImpl(T&& value, size_t field_hash, Fn&& fn)
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        size_t         index      = field_npos;
         find_if_tuple_index(meta_class.member_info_tuple,
-                      [&fn, &value, field_hash](const auto& field_info, size_t idx) constexpr -> bool
+                      [&fn, &value, &index, field_hash](const auto& field_info, size_t idx) constexpr -> bool
                       {
                           if(field_info.field_name_hash != field_hash)
                               return false;
-
-                          if constexpr(is_member_ptr<decltype(field_info)>())
-                          {
-                              return fn(field_info, value.*(field_info.ptr));
-                          }
-                          else if constexpr(is_member_ptr_tag<decltype(field_info)>())
-                          {
-                              return fn(field_info, value.*(field_info.ptr), field_info.tag);
-                          }
-                          else if constexpr(is_member_ptr_func<decltype(field_info)>())
+                          if(!InvokeFieldFn(value, field_info, fn))
                           {
-                              return fn(field_info, value.*(field_info.ptr), field_info.func);
+                              index = field_rejected;
+                              return false;
                           }
 
-                          return false;
+                          index = idx;
+                          return true;
                       });
+        return index;
+    }
+
+    template<typename T, typename Fn>
+    inline constexpr size_t FindInFieldIndex(T&& value, size_t field_hash, Fn&& fn)
+    {
+        static_assert(getClassMemberSize<T>() != 0,
+                      "MetaClass<T>() for type T should be specialized to return "
+                      "FieldSchema tuples, like ((&T::field, field_name), ...)");
+#ifdef STATIC_REFLECTION_ENABLE_STATS
+        constexpr auto                                 meta_class = getClassMetaInfo<T>();
+        stats::counted_fn<std::remove_reference_t<Fn>> counted{meta_class.class_name, field_hash, fn};
+        size_t                                         index = FindInFieldImpl(value, field_hash, counted);
+        if(!counted.found)
+            stats::record_unknown(meta_class.class_name, field_hash);
+        return index;
+#else
+        return FindInFieldImpl(value, field_hash, fn);
+#endif
+    }
+
+    // true if a field matched field_hash and fn returned true
+    template<typename T, typename Fn>
+    inline constexpr bool FindInField(T&& value, size_t field_hash, Fn&& fn)
+    {
+        return field_found(FindInFieldIndex(value, field_hash, fn));
+    }
+
+    // the members of T seen while decoding one object, plus the keys that matched none and the values fn refused
+    template<class T>
+    struct FieldVisitSet
+    {
+        static constexpr size_t size = getClassMemberSize<T>();
+
+        // member functions are never decoded, so they are never missing
+        static inline const std::bitset<size> data_members = []()
+        {
+            std::bitset<size> mask;
+            for_each_tuple_index(getClassMetaInfo<T>().member_info_tuple,
+                                 [&mask](const auto& field_info, auto idx)
+                                 {
+                                     if constexpr(!is_member_func<decltype(field_info)>())
+                                         mask.set(idx);
+                                 });
+            return mask;
+        }();
+
+        std::bitset<size> visited;
+        size_t            unknown_keys  = 0;
+        size_t            rejected_keys = 0;
+
+        void mark(size_t index)
+        {
+            if(index == field_npos)
+                unknown_keys++;
+            else if(index == field_rejected)
+                rejected_keys++;
+            else
+                visited.set(index);
+        }
+
+        std::bitset<size> missing_fields() const { return data_members & ~visited; }
+        bool              all_visited() const { return missing_fields().none(); }
+        size_t            unknown_key_count() const { return unknown_keys; }
+        size_t            rejected_key_count() const { return rejected_keys; }
+
+        // fn(field_info) for every member that was not visited
+        template<class Fn>
+        void for_each_missing(Fn&& fn) const
+        {
+            constexpr auto meta_class = getClassMetaInfo<T>();
+            auto           missing    = missing_fields();
+            for_each_tuple_index(meta_class.member_info_tuple,
+                                 [&fn, &missing](const auto& field_info, auto idx)
+                                 {
+                                     if(missing.test(idx))
+                                         fn(field_info);
+                                 });
+        }
+    };
+
+    // FindInField that also records the lookup in visit_set, one bit set or one counter bumped
+    template<typename T, typename Fn>
+    inline bool FindInField(T&& value, size_t field_hash, FieldVisitSet<std::decay_t<T>>& visit_set, Fn&& fn)
+    {
+        size_t index = FindInFieldIndex(value, field_hash, fn);
+        visit_set.mark(index);
+        return field_found(index);
     }
 
 } // namespace static_reflection_v2
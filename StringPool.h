@@ -0,0 +1,196 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    // append-only set of strings: intern() returns the one copy of a value, valid for the life of the pool
+    // 16 shards with a lock and an open addressing table each, loaders on several threads can share one pool
+    class string_pool
+    {
+    public:
+        static constexpr size_t shard_count = 16;
+        static constexpr size_t chunk_size  = 64 * 1024;
+
+        string_pool() = default;
+
+        string_pool(const string_pool&)            = delete;
+        string_pool& operator=(const string_pool&) = delete;
+
+        std::string_view intern(std::string_view str)
+        {
+            if(str.empty())
+                return std::string_view("", 0);
+
+            size_t hash   = std::hash<std::string_view>{}(str);
+            shard& target = shards[hash >> (sizeof(size_t) * 8 - 4)];
+
+            std::lock_guard<std::mutex> lock(target.mutex);
+            size_t                      mask = target.slots.size() - 1;
+            size_t                      pos  = hash & mask;
+            for(; target.slots[pos].data != nullptr; pos = (pos + 1) & mask)
+            {
+                const slot& entry = target.slots[pos];
+                if(entry.hash == hash && std::string_view(entry.data, entry.size) == str)
+                    return std::string_view(entry.data, entry.size);
+            }
+
+            const char* data = target.append(str);
+            target.slots[pos] = slot{data, str.size(), hash};
+            // at most half full keeps the probes short
+            if(++target.count * 2 > target.slots.size())
+                target.grow();
+            return std::string_view(data, str.size());
+        }
+
+        // distinct strings held
+        size_t size() const
+        {
+            size_t count = 0;
+            for(const shard& s: shards)
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                count += s.count;
+            }
+            return count;
+        }
+
+        // bytes of string data held, the tables not included
+        size_t bytes() const
+        {
+            size_t count = 0;
+            for(const shard& s: shards)
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                count += s.bytes;
+            }
+            return count;
+        }
+
+    private:
+        struct slot
+        {
+            const char* data = nullptr;
+            size_t      size = 0;
+            size_t      hash = 0;
+        };
+
+        // one cache line each at least, so threads on different shards do not share a lock line
+        struct alignas(64) shard
+        {
+            mutable std::mutex                   mutex;
+            std::vector<slot>                    slots = std::vector<slot>(64);
+            size_t                               count = 0;
+            size_t                               bytes = 0;
+            std::vector<std::unique_ptr<char[]>> chunks;
+            char*                                chunk_pos  = nullptr;
+            size_t                               chunk_left = 0;
+
+            const char* append(std::string_view str)
+            {
+                if(str.size() > chunk_left)
+                {
+                    // a long string gets a chunk of its own, the current one keeps filling
+                    if(str.size() > chunk_size / 4)
+                    {
+                        chunks.push_back(std::make_unique<char[]>(str.size()));
+                        std::memcpy(chunks.back().get(), str.data(), str.size());
+                        bytes += str.size();
+                        return chunks.back().get();
+                    }
+                    chunks.push_back(std::make_unique<char[]>(chunk_size));
+                    chunk_pos  = chunks.back().get();
+                    chunk_left = chunk_size;
+                }
+                char* data = chunk_pos;
+                std::memcpy(data, str.data(), str.size());
+                chunk_pos += str.size();
+                chunk_left -= str.size();
+                bytes += str.size();
+                return data;
+            }
+
+            void grow()
+            {
+                std::vector<slot> larger(slots.size() * 2);
+                size_t            mask = larger.size() - 1;
+                for(const slot& entry: slots)
+                {
+                    if(entry.data == nullptr)
+                        continue;
+                    size_t pos = entry.hash & mask;
+                    while(larger[pos].data != nullptr)
+                        pos = (pos + 1) & mask;
+                    larger[pos] = entry;
+                }
+                slots = std::move(larger);
+            }
+        };
+
+        std::array<shard, shard_count> shards;
+    };
+
+    // the pool of loads without a string_pool_scope, lives until the program exits
+    inline string_pool& default_string_pool()
+    {
+        static string_pool pool;
+        return pool;
+    }
+
+    inline string_pool*& current_string_pool_slot()
+    {
+        thread_local string_pool* pool = nullptr;
+        return pool;
+    }
+
+    // pool the META_MEMBER_INTERN members loaded on this thread go to
+    inline string_pool& current_string_pool()
+    {
+        string_pool* pool = current_string_pool_slot();
+        return pool != nullptr ? *pool : default_string_pool();
+    }
+
+    // loads on this thread intern into pool until the scope ends
+    // string_pool pool;
+    // string_pool_scope scope(pool);
+    class string_pool_scope
+    {
+    public:
+        explicit string_pool_scope(string_pool& pool)
+            : previous(std::exchange(current_string_pool_slot(), &pool))
+        {
+        }
+        ~string_pool_scope() { current_string_pool_slot() = previous; }
+
+        string_pool_scope(const string_pool_scope&)            = delete;
+        string_pool_scope& operator=(const string_pool_scope&) = delete;
+
+    private:
+        string_pool* previous;
+    };
+
+    // true if the trailing arguments a loader's field callback gets hold intern_tag
+    template<class... Extra>
+    inline constexpr bool is_intern_field = (std::is_same_v<std::decay_t<Extra>, intern_tag> || ...);
+
+    template<class FieldType>
+    inline void intern_to_field(std::string_view str, FieldType& field)
+    {
+        static_assert(std::is_same_v<FieldType, std::string_view>, "META_MEMBER_INTERN members are std::string_view into the string pool");
+        field = current_string_pool().intern(str);
+    }
+} // namespace static_reflection_v2
+
+#endif /* STRINGPOOL_H */
@@ -1,6 +1,7 @@
 #ifndef TUPLEHELPER_H
 #define TUPLEHELPER_H
 
+#include <array>
 #include <optional>
 #include <tuple>
 #include <type_traits>
@@ -116,6 +117,27 @@ constexpr decltype(auto) find_if_tuple_index(tuple_type&& tuple, ftype&& f)
      std::make_index_sequence<std::tuple_size<std::remove_reference_t<tuple_type>>::value>{});
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+// f(std::get<idx>(tuple)) for a runtime idx, through a table of function pointers instead of a fold
+// idx must be less than the tuple size, every f(std::get<I>(tuple)) must return the same type
+template<class tuple_type, class ftype>
+constexpr decltype(auto) visit_tuple_at(tuple_type&& tuple, std::size_t idx, ftype&& f)
+{
+    constexpr std::size_t size = std::tuple_size<std::remove_reference_t<tuple_type>>::value;
+    static_assert(size != 0, "visit_tuple_at on an empty tuple");
+
+    using result_t = decltype(f(std::get<0>(std::forward<tuple_type>(tuple))));
+    using thunk_t  = result_t (*)(tuple_type&&, ftype&);
+
+    constexpr auto jump_table = []<std::size_t... I>(std::index_sequence<I...>)
+    {
+        return std::array<thunk_t, size>{[](tuple_type&& tuple, ftype& f) -> result_t
+                                         { return f(std::get<I>(std::forward<tuple_type>(tuple))); }...};
+    }
+    (std::make_index_sequence<size>{});
+    return jump_table[idx](std::forward<tuple_type>(tuple), f);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template<class... Ts>
@@ -0,0 +1,129 @@
+#ifndef TYPEFACTORY_H
+#define TYPEFACTORY_H
+
+#include <array>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "PerfectHash.h"
+#include "StaticReflectionV2.h"
+
+namespace static_reflection_v2
+{
+    template<class T>
+    constexpr size_t getClassNameHash()
+    {
+        constexpr auto meta_class = getClassMetaInfo<T>();
+        return make_string_hash(meta_class.class_name);
+    }
+
+    template<class T>
+    struct type_tag
+    {
+        using type = T;
+    };
+
+    // perfect hash from ClassInfo::class_name to a slot of Types...
+    template<class... Types>
+    struct TypeNameTable
+    {
+        static constexpr size_t size = sizeof...(Types);
+
+        static constexpr auto class_name_array = std::array<const char*, size>{getClassMetaInfo<Types>().class_name...};
+        static constexpr auto name_hash_table  = make_perfect_hash(std::array<size_t, size>{getClassNameHash<Types>()...});
+
+        // npos if class_name is not one of Types
+        static constexpr size_t find(std::string_view class_name)
+        {
+            size_t index = name_hash_table.find(make_string_hash(class_name));
+            if(index == name_hash_table.npos || class_name != class_name_array[index])
+                return name_hash_table.npos;
+            return index;
+        }
+    };
+
+    // fn(type_tag<T>{}, std::integral_constant<size_t, I>{}) for the I-th type named class_name
+    template<class... Types, class Fn>
+    inline bool VisitTypeByName(std::string_view class_name, Fn&& fn)
+    {
+        using table  = TypeNameTable<Types...>;
+        size_t index = table::find(class_name);
+        if(index == table::name_hash_table.npos)
+            return false;
+
+        using thunk_t                    = bool (*)(Fn&);
+        static constexpr auto jump_table = []<size_t... I>(std::index_sequence<I...>) constexpr
+        {
+            return std::array<thunk_t, sizeof...(Types)>{[](Fn& f) -> bool
+                                                         {
+                                                             using T = std::tuple_element_t<I, std::tuple<Types...>>;
+                                                             return f(type_tag<T>{}, std::integral_constant<size_t, I>{});
+                                                         }...};
+        }
+        (std::index_sequence_for<Types...>{});
+        return jump_table[index](fn);
+    }
+
+    template<class Target>
+    struct TypeFactory;
+
+    template<class... Types>
+    struct TypeFactory<std::variant<Types...>>
+    {
+        template<class Fn>
+        static bool create(std::variant<Types...>& target, std::string_view class_name, Fn& fn)
+        {
+            return VisitTypeByName<Types...>(class_name,
+                                             [&target, &fn](auto, auto index)
+                                             {
+                                                 fn(target.template emplace<index()>());
+                                                 return true;
+                                             });
+        }
+    };
+
+    // a reflected union, each member type with its own DEFINE_META
+    template<class Union, class MemberTuple = decltype(getClassMetaInfo<Union>().member_info_tuple)>
+    struct UnionFactory;
+
+    template<class Union, class... FieldInfo>
+    struct UnionFactory<Union, std::tuple<FieldInfo...>>
+    {
+        template<class Fn>
+        static bool create(Union& target, std::string_view class_name, Fn& fn)
+        {
+            return VisitTypeByName<typename member_ptr_traits<decltype(FieldInfo::ptr)>::member_type...>(
+                class_name,
+                [&target, &fn](auto type, auto index)
+                {
+                    using member_type = typename decltype(type)::type;
+                    static_assert(std::is_trivially_destructible_v<member_type>, "the active union member is replaced without being destroyed");
+
+                    constexpr auto field_info = std::get<index()>(getClassMetaInfo<Union>().member_info_tuple);
+                    // begins the lifetime of the selected member
+                    fn(*std::construct_at(&(target.*(field_info.ptr))));
+                    return true;
+                });
+        }
+    };
+
+    template<class Union>
+        requires(std::is_union_v<Union> && have_meta_info<Union>::value)
+    struct TypeFactory<Union> : UnionFactory<Union>
+    {
+    };
+
+    // create the alternative of target whose class_name matches, then fn(alternative&) decodes into it in place
+    //   CreateByName(node_union, pNodeE->Name(), [pNodeE](auto& node) { xmlElement_to_struct(pNodeE, node); });
+    template<class Target, class Fn>
+    inline bool CreateByName(Target& target, std::string_view class_name, Fn&& fn)
+    {
+        return TypeFactory<Target>::create(target, class_name, fn);
+    }
+} // namespace static_reflection_v2
+
+#endif /* TYPEFACTORY_H */
@@ -0,0 +1,303 @@
+// hash throughput and quality over identifier-like keys
+//   g++ -std=c++20 -O2 -mavx2 -I. hash_bench.cpp -o hash_bench
+//   ./hash_bench test.cpp other_sources.cpp ...
+// the field names of every DEFINE_META in the given sources form the second corpus
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <regex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "PerfectHash.h"
+#include "StaticHash.h"
+#include "StaticHashBatch.h"
+
+struct HashEntry
+{
+    const char* name;
+    uint64_t (*fn)(std::string_view);
+};
+
+template<class Policy>
+uint64_t policy_hash(std::string_view key)
+{
+    return Policy::hash(key.data(), key.size());
+}
+
+static const HashEntry hash_entries[] = {
+    {"murmur3", &policy_hash<hash::murmur3_policy>},
+    {"xxh32",   &policy_hash<hash::xxh32_policy>  },
+    {"xxh64",   &policy_hash<hash::xxh64_policy>  },
+    {"fnv1a",   &policy_hash<hash::fnv1a_policy>  },
+    {"djb2a",   &policy_hash<hash::djb2a_policy>  },
+    {"crc32",   &policy_hash<hash::crc32_policy>  },
+};
+
+// iWaitTimeCast, stOnCastOut, cast_time_ms, ...
+std::vector<std::string> make_identifier_corpus(size_t count, uint32_t seed)
+{
+    static const char* prefixes[] = {"", "i", "n", "b", "f", "st", "sz", "m_", "p"};
+    static const char* words[]    = {"wait", "time", "cast", "end",   "start", "out",  "cnt",  "node", "flow",   "action", "break", "move",
+                                     "id",   "name", "type", "value", "count", "max",  "min",  "list", "config", "level",  "skill", "buff",
+                                     "hp",   "mp",   "pos",  "x",     "y",     "z",    "dir",  "rate", "delay",  "target", "range", "cool",
+                                     "down", "user", "item", "slot",  "flag",  "mask", "seed", "last", "next",   "prev",   "total", "index"};
+
+    std::mt19937             rng(seed);
+    std::set<std::string>    unique;
+    std::vector<std::string> corpus;
+    while(corpus.size() < count)
+    {
+        bool        snake = rng() % 4 == 0;
+        std::string key   = snake ? "" : prefixes[rng() % std::size(prefixes)];
+        size_t      parts = 1 + rng() % 4;
+        for(size_t i = 0; i < parts; i++)
+        {
+            std::string word = words[rng() % std::size(words)];
+            if(snake)
+            {
+                key += (i == 0 ? "" : "_") + word;
+            }
+            else
+            {
+                if(!key.empty() || i > 0)
+                    word[0] = char(word[0] - 'a' + 'A');
+                key += word;
+            }
+        }
+        if(rng() % 3 == 0)
+            key += std::to_string(rng() % 100);
+        if(unique.insert(key).second)
+            corpus.push_back(key);
+    }
+    return corpus;
+}
+
+// META_MEMBER(x), META_MEMBER_NAME(x, "name"), META_MEMBER_BIND("name", ...), META_FUNCTION(f), META_ENUM_VALUE(v) ...
+// DEFINE_META_DERIVED / DEFINE_META_HASH name classes and are skipped
+std::vector<std::string> make_meta_corpus(int argc, char** argv)
+{
+    static const std::regex meta_regex(R"((?:^|[^A-Z_])META_[A-Z_]+\(\s*(?:\"([^\"]+)\"|(\w+)\s*(?:,\s*\"([^\"]+)\")?))");
+
+    std::set<std::string> unique;
+    for(int i = 1; i < argc; i++)
+    {
+        std::ifstream ifs(argv[i]);
+        if(!ifs)
+        {
+            fprintf(stderr, "can not open %s\n", argv[i]);
+            continue;
+        }
+
+        std::string line;
+        while(std::getline(ifs, line))
+        {
+            // macro definitions name parameters, not fields
+            if(line.find("#define") != std::string::npos)
+                continue;
+            for(std::sregex_iterator it(line.begin(), line.end(), meta_regex), end; it != end; ++it)
+            {
+                const auto& match = *it;
+                std::string name  = match[1].matched ? match[1].str() : match[3].matched ? match[3].str() : match[2].str();
+                unique.insert(name);
+            }
+        }
+    }
+    return std::vector<std::string>(unique.begin(), unique.end());
+}
+
+// keeps the hash results alive
+volatile uint64_t bench_sink = 0;
+
+template<class Fn>
+double measure_ns_per_key(const std::vector<std::string_view>& keys, Fn&& fn)
+{
+    const size_t rounds = std::max<size_t>(1, 2000000 / std::max<size_t>(1, keys.size()));
+    uint64_t     sink   = 0;
+    auto         begin  = std::chrono::steady_clock::now();
+    for(size_t r = 0; r < rounds; r++)
+        sink += fn(keys);
+    auto end = std::chrono::steady_clock::now();
+
+    bench_sink = sink;
+    return std::chrono::duration<double, std::nano>(end - begin).count() / double(rounds * keys.size());
+}
+
+void report_throughput()
+{
+    struct LengthRange
+    {
+        size_t min_length;
+        size_t max_length;
+    };
+    static const LengthRange ranges[] = {
+        {1,  4 },
+        {5,  8 },
+        {9,  16},
+        {17, 32},
+        {33, 64},
+    };
+
+    printf("throughput, ns/key\n%-10s", "length");
+    for(const auto& range: ranges)
+        printf(" %7zu-%-3zu", range.min_length, range.max_length);
+    printf("\n");
+
+    std::mt19937                          rng(1);
+    std::vector<std::vector<std::string>> range_keys;
+    for(const auto& range: ranges)
+    {
+        std::vector<std::string> keys(4096);
+        for(auto& key: keys)
+        {
+            size_t length = range.min_length + rng() % (range.max_length - range.min_length + 1);
+            for(size_t i = 0; i < length; i++)
+                key += char('a' + rng() % 26);
+        }
+        range_keys.push_back(std::move(keys));
+    }
+
+    auto print_row = [&range_keys](const char* name, auto&& fn)
+    {
+        printf("%-10s", name);
+        for(const auto& keys: range_keys)
+            printf(" %11.2f", measure_ns_per_key(std::vector<std::string_view>(keys.begin(), keys.end()), fn));
+        printf("\n");
+    };
+
+    for(const auto& entry: hash_entries)
+    {
+        print_row(entry.name,
+                  [&entry](const std::vector<std::string_view>& keys)
+                  {
+                      uint64_t sum = 0;
+                      for(auto key: keys)
+                          sum += entry.fn(key);
+                      return sum;
+                  });
+    }
+
+    std::vector<uint32_t> out(4096);
+    print_row("hash_many",
+              [&out](const std::vector<std::string_view>& keys)
+              {
+                  hash::hash_many(keys, out);
+                  return uint64_t(out[0]);
+              });
+    printf("\n");
+}
+
+// the pilots make_perfect_hash would search: buckets placed biggest first, each with the first pilot that moves
+// all its keys to free slots; the largest pilot any bucket needed, npos where make_perfect_hash gives up
+size_t max_perfect_hash_pilot(const std::vector<uint64_t>& hashes, size_t table_size, size_t bucket_size)
+{
+    std::vector<std::vector<size_t>> buckets(bucket_size);
+    for(uint64_t h: hashes)
+        buckets[static_reflection_v2::perfect_hash_bucket(size_t(h), bucket_size)].push_back(size_t(h));
+    std::stable_sort(buckets.begin(), buckets.end(), [](const auto& a, const auto& b) { return a.size() > b.size(); });
+
+    std::vector<uint8_t> used(table_size);
+    std::vector<size_t>  placed;
+    size_t               max_pilot = 0;
+    for(const auto& bucket: buckets)
+    {
+        for(size_t pilot = 0;; pilot++)
+        {
+            if(pilot > 0xFFFFF)
+                return std::string::npos;
+
+            placed.clear();
+            for(size_t h: bucket)
+            {
+                size_t pos = static_reflection_v2::perfect_hash_slot(h, pilot, table_size);
+                if(used[pos])
+                    break;
+                used[pos] = 1;
+                placed.push_back(pos);
+            }
+            if(placed.size() == bucket.size())
+            {
+                max_pilot = std::max(max_pilot, pilot);
+                break;
+            }
+            for(size_t pos: placed)
+                used[pos] = 0;
+        }
+    }
+    return max_pilot;
+}
+
+// collisions at full width, through PerfectHash.h's slot reduction with pilot 0, the spread over its buckets
+// and the largest pilot make_perfect_hash would need
+void report_quality(const char* corpus_name, const std::vector<std::string>& corpus)
+{
+    const size_t n           = corpus.size();
+    const size_t table_size  = static_reflection_v2::perfect_hash_table_size(n);
+    const size_t bucket_size = static_reflection_v2::perfect_hash_bucket_size(n);
+    const double expected    = double(n) - double(table_size) * (1.0 - std::pow(1.0 - 1.0 / double(table_size), double(n)));
+
+    printf("%s: %zu keys, table %zu slots, %zu buckets, expected slot collisions %.1f\n", corpus_name, n, table_size, bucket_size, expected);
+    printf("%-10s %10s %10s %10s %10s %10s\n", "hash", "full", "slot", "max_bucket", "chi2/df", "max_pilot");
+    for(const auto& entry: hash_entries)
+    {
+        std::vector<uint64_t> hashes;
+        for(const auto& key: corpus)
+            hashes.push_back(entry.fn(key));
+
+        std::vector<uint64_t> sorted = hashes;
+        std::sort(sorted.begin(), sorted.end());
+        size_t full_collisions = n - size_t(std::unique(sorted.begin(), sorted.end()) - sorted.begin());
+
+        std::vector<uint8_t> used(table_size);
+        size_t               slot_collisions = 0;
+        std::vector<size_t>  buckets(bucket_size);
+        for(uint64_t h: hashes)
+        {
+            auto& slot = used[static_reflection_v2::perfect_hash_slot(size_t(h), 0, table_size)];
+            slot_collisions += slot;
+            slot = 1;
+            buckets[static_reflection_v2::perfect_hash_bucket(size_t(h), bucket_size)]++;
+        }
+
+        double mean = double(n) / double(bucket_size);
+        double chi2 = 0;
+        for(size_t count: buckets)
+            chi2 += (double(count) - mean) * (double(count) - mean) / mean;
+
+        printf("%-10s %10zu %10zu %10zu %10.3f", entry.name, full_collisions, slot_collisions, *std::max_element(buckets.begin(), buckets.end()),
+               bucket_size > 1 ? chi2 / double(bucket_size - 1) : 0.0);
+        // a duplicate hash never fits
+        size_t max_pilot = full_collisions == 0 ? max_perfect_hash_pilot(hashes, table_size, bucket_size) : std::string::npos;
+        if(max_pilot == std::string::npos)
+            printf(" %10s\n", "fail");
+        else
+            printf(" %10zu\n", max_pilot);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    report_throughput();
+
+    for(size_t count: {size_t(256), size_t(4096), size_t(100000)})
+    {
+        std::string name = "identifiers " + std::to_string(count);
+        report_quality(name.c_str(), make_identifier_corpus(count, uint32_t(count)));
+    }
+
+    auto meta_corpus = make_meta_corpus(argc, argv);
+    if(meta_corpus.empty())
+        printf("DEFINE_META names: no sources given or no names found\n");
+    else
+        report_quality("DEFINE_META names", meta_corpus);
+    return 0;
+}
@@ -0,0 +1,146 @@
+// json_stream_decoder fed through a pipe in chunks of every size, checked against json_to_struct on the whole document
+//   g++ -std=c++20 -O2 -I. json_stream_pipe.cpp -o json_stream_pipe -pthread
+//   ./json_stream_pipe [document.json]
+// without an argument a built-in document is used; exits with 1 when a chunking decodes differently
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "FormatStruct.h"
+#include "JsonStreamDecoder.h"
+#include "JsonToStruct.h"
+
+enum class FeedKind
+{
+    Quote,
+    Trade
+};
+DEFINE_ENUM_META(FeedKind, META_ENUM_VALUE(Quote), META_ENUM_VALUE(Trade));
+
+struct FeedLevel
+{
+    double price = 0;
+    int    size  = 0;
+};
+DEFINE_META(FeedLevel, DEFINE_MEMBER(META_MEMBER(price), META_MEMBER(size)));
+
+struct FeedMessage
+{
+    uint64_t                 seq  = 0;
+    FeedKind                 kind = FeedKind::Quote;
+    std::string              symbol;
+    bool                     live = false;
+    int                      venue_id = 0;
+    int                      venue_copy = 0;
+    FeedLevel                top;
+    std::vector<double>      prices;
+    std::vector<std::string> tags;
+    int                      flags[3] = {};
+    std::array<double, 2>    band{};
+};
+DEFINE_META(FeedMessage, DEFINE_MEMBER(META_MEMBER(seq), META_MEMBER(kind), META_MEMBER(symbol), META_MEMBER(live),
+                                       META_MEMBER_BIND("venue", META_BIND(venue_id), META_BIND(venue_copy)), META_MEMBER(top), META_MEMBER(prices),
+                                       META_MEMBER(tags), META_MEMBER(flags), META_MEMBER(band)));
+
+static const char* builtin_document = R"({
+    "seq": 18446744073709551615, "kind": "Trade", "symbol": "ABç 😀 \"q\"\n", "live": true, "venue": 7,
+    "top": {"price": 101.25, "size": 300},
+    "prices": [101.0, 100.5e0, -2.5, 99],
+    "unknown": {"nested": [1, {"deep": null}, "x"]},
+    "tags": ["a", "b", ""], "flags": [1, -2, 3], "band": [-0.5, 1E+2]
+})";
+
+static std::string format_message(const FeedMessage& message)
+{
+    std::string out;
+    static_reflection_v2::format_to(out, message, {.max_elements = 1024});
+    return out;
+}
+
+// the document written to a pipe chunk by chunk from another thread, read back in reads of read_size bytes
+static bool decode_through_pipe(std::string_view document, size_t write_size, size_t read_size, FeedMessage& message)
+{
+    int fds[2];
+    if(pipe(fds) != 0)
+        return false;
+
+    std::thread writer(
+        [&document, write_size, fd = fds[1]]()
+        {
+            for(size_t pos = 0; pos < document.size();)
+            {
+                ssize_t written = write(fd, document.data() + pos, std::min(write_size, document.size() - pos));
+                if(written <= 0)
+                    break;
+                pos += size_t(written);
+            }
+            close(fd);
+        });
+
+    static_reflection_v2::json_stream_decoder<FeedMessage> decoder(message);
+    std::vector<char>                                      buffer(read_size);
+    ssize_t                                                n;
+    while((n = read(fds[0], buffer.data(), buffer.size())) > 0)
+    {
+        if(decoder.feed({buffer.data(), size_t(n)}) != static_reflection_v2::json_stream_status::need_more)
+            break;
+    }
+    writer.join();
+    close(fds[0]);
+    return decoder.finish() == static_reflection_v2::json_stream_status::done;
+}
+
+int main(int argc, char** argv)
+{
+    std::string document = builtin_document;
+    if(argc > 1)
+    {
+        std::ifstream ifs(argv[1], std::ios::binary);
+        if(!ifs)
+        {
+            printf("cannot open %s\n", argv[1]);
+            return 1;
+        }
+        document.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    FeedMessage expected;
+    try
+    {
+        json_to_struct(nlohmann::json::parse(document), expected);
+    }
+    catch(const nlohmann::json::exception& e)
+    {
+        printf("json_to_struct: %s\n", e.what());
+        return 1;
+    }
+    std::string expected_text = format_message(expected);
+    printf("%s\n", expected_text.c_str());
+
+    std::mt19937 rng(1);
+    size_t       failures = 0;
+    size_t       runs     = 0;
+    for(size_t write_size = 1; write_size <= 64; write_size++)
+    {
+        size_t      read_size = 1 + rng() % 97;
+        FeedMessage message;
+        runs++;
+        if(!decode_through_pipe(document, write_size, read_size, message) || format_message(message) != expected_text)
+        {
+            printf("write %zu read %zu: decoded differently\n", write_size, read_size);
+            failures++;
+        }
+    }
+    printf("%zu of %zu chunkings decoded like json_to_struct\n", runs - failures, runs);
+    return failures == 0 ? 0 : 1;
+}
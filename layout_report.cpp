@@ -0,0 +1,36 @@
+// size, padding, cache line crossings and a suggested member order for every listed reflected type
+//   g++ -std=c++20 -I. -DLAYOUT_REPORT_HEADER='"game_types.h"' -DLAYOUT_REPORT_TYPES='Session, Trade' layout_report.cpp -o layout_report
+//   ./layout_report
+// there is no registry of reflected types, the header with the DEFINE_META and the type list are given here;
+// -DLAYOUT_REPORT_MAX_PADDING=N makes it exit with 1 when a type has more padding or hot members over one cache line
+
+#include <cstdio>
+
+#include "LayoutReport.h"
+
+#if !defined(LAYOUT_REPORT_HEADER) || !defined(LAYOUT_REPORT_TYPES)
+#error "-DLAYOUT_REPORT_HEADER='\"types.h\"' -DLAYOUT_REPORT_TYPES='A, B' names the reflected types to report"
+#endif
+
+#include LAYOUT_REPORT_HEADER
+
+template<class... Types>
+int ReportTypes()
+{
+    static_reflection_v2::PrintLayoutReport<Types...>(stdout);
+#ifdef LAYOUT_REPORT_MAX_PADDING
+    // the measured figures, the ones printed above
+    bool within_budget = (static_reflection_v2::measured_within_budget<Types>(LAYOUT_REPORT_MAX_PADDING) && ...);
+    if(!within_budget)
+    {
+        printf("over budget: more than %d bytes of padding or hot members over one cache line\n", int(LAYOUT_REPORT_MAX_PADDING));
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+int main()
+{
+    return ReportTypes<LAYOUT_REPORT_TYPES>();
+}
@@ -0,0 +1,136 @@
+// json_to_struct into pmr members, with and without a monotonic_buffer_resource
+//   g++ -std=c++20 -O2 -I. pmr_bench.cpp -o pmr_bench
+//   ./pmr_bench [item_count]
+// operator new is counted by this program, so the allocation column is exact; times are the best of 5 runs
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+#include "JsonToStruct.h"
+
+static size_t new_count = 0;
+
+void* operator new(size_t size)
+{
+    new_count++;
+    if(void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// new_delete_resource() asks for aligned storage
+void* operator new(size_t size, std::align_val_t align)
+{
+    new_count++;
+    size_t alignment = std::max(size_t(align), sizeof(void*));
+    if(void* p = std::aligned_alloc(alignment, (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+struct BenchItem
+{
+    int32_t                              id = 0;
+    std::pmr::string                     name;
+    std::pmr::vector<std::pmr::string>   tags;
+    std::pmr::map<std::pmr::string, int> stats;
+};
+DEFINE_META(BenchItem, DEFINE_MEMBER(META_MEMBER(id), META_MEMBER(name), META_MEMBER(tags), META_MEMBER(stats)));
+
+struct BenchDoc
+{
+    std::pmr::vector<BenchItem> items;
+};
+DEFINE_META(BenchDoc, DEFINE_MEMBER(META_MEMBER(items)));
+
+// keeps the decoded documents alive
+volatile size_t bench_sink = 0;
+
+struct BenchResult
+{
+    double us;
+    size_t allocations;
+};
+
+// best time of the runs, allocations of the last one
+template<class Decode>
+BenchResult measure_decode(Decode&& decode)
+{
+    BenchResult best{1e300, 0};
+    for(int run = 0; run < 5; run++)
+    {
+        size_t count_before = new_count;
+        auto   begin        = std::chrono::steady_clock::now();
+        bench_sink          = decode();
+        auto end            = std::chrono::steady_clock::now();
+        best.us             = std::min(best.us, std::chrono::duration<double, std::micro>(end - begin).count());
+        best.allocations    = new_count - count_before;
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    size_t item_count = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 20000;
+
+    nlohmann::json doc;
+    for(size_t i = 0; i < item_count; i++)
+    {
+        nlohmann::json item;
+        item["id"]    = i;
+        item["name"]  = "an item name long enough to leave the small string buffer " + std::to_string(i);
+        item["tags"]  = {"category-alpha-long-tag", "category-beta-long-tag"};
+        item["stats"] = {{"strength-long-stat-name", 1}, {"agility-long-stat-name", 2}};
+        doc["items"].push_back(std::move(item));
+    }
+
+    // every pmr member on the default resource, new_delete_resource()
+    BenchResult heap = measure_decode(
+        [&doc]()
+        {
+            BenchDoc decoded;
+            json_to_struct(doc, decoded);
+            return decoded.items.size();
+        });
+
+    BenchResult arena = measure_decode(
+        [&doc]()
+        {
+            std::pmr::monotonic_buffer_resource resource(1 << 20);
+            BenchDoc                            decoded;
+            json_to_struct(doc, decoded, &resource);
+            return decoded.items.size();
+        });
+
+    printf("%zu items, decode and release\n", item_count);
+    printf("%-10s %12s %12s\n", "resource", "us", "allocations");
+    printf("%-10s %12.0f %12zu\n", "default", heap.us, heap.allocations);
+    printf("%-10s %12.0f %12zu\n", "arena", arena.us, arena.allocations);
+    return 0;
+}
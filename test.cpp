@@ -1,7 +1,13 @@
 #include <cstdint>
+#include <cstring>
+#include <memory_resource>
 #include <string>
 
 #include "static_reflection.h"
+#include "StaticEnum.h"
+#include "StaticReflectionV2.h"
+#include "StringPool.h"
+#include "TypeFactory.h"
 #include "tinyxml2/tinyxml2.h"
 #include  <functional>
 
@@ -41,6 +47,7 @@ constexpr auto FUNCCC = [](tinyxml2::XMLElement*, int* field)->void
 
 
 
+//the V1 schema of the same struct, main checks its breakTime bind against the V2 one
 DEFINE_STRUCT_SCHEMA(ActionFlowLCast,
                      DEFINE_STRUCT_FIELD_BIND("breakTime", 
 							BIND_FIELD_TAG(iWaitTimeQianYao, ELF_HASH_TAG),
@@ -54,39 +61,72 @@ DEFINE_STRUCT_SCHEMA(ActionFlowLCast,
                      DEFINE_STRUCT_FIELD(stOnEndOut, "onEnd"));
 
 
+DEFINE_META(ActionFlowLCast,
+            DEFINE_MEMBER(
+                META_MEMBER_BIND("breakTime",
+                    META_BIND_TAG(iWaitTimeQianYao, ElfHash_tag),
+                    META_BIND(iWaitTimeMoveQianYao)),
+                META_MEMBER_NAME_TAG(iWaitTimeCast, "castTime", ElfHash_tag),
+                META_MEMBER_NAME_FUNC(iWaitTimeFinish, "endTime", FUNCCC),
+
+                META_MEMBER_NAME(stOnStartOut, "onStart"),
+                META_MEMBER_NAME(stOnQianYaoOut, "onBreak"),
+                META_MEMBER_NAME(stOnCastOut, "onCast"),
+                META_MEMBER_NAME(stOnEndOut, "onEnd")));
+
+
 typedef union
 {
     ACTIONFLOWLCAST stCast;
 
 } ActionFlowNodeOneUnion;
 
+DEFINE_META(ActionFlowNodeOneUnion,
+            DEFINE_MEMBER(
+                META_MEMBER(stCast)));
+
 
 
 
 
 template<class T>
-void xmlElement_to_struct(tinyxml2::XMLElement* pE, T& refStruct);
+void xmlElement_to_struct(tinyxml2::XMLElement* pE, T& refStruct, std::pmr::memory_resource* resource = nullptr);
 
 template<class FieldType >
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, FieldType* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, FieldType* field, std::pmr::memory_resource* resource = nullptr)
 {
-	xmlElement_to_struct(pVarE, *field);
+	if constexpr (std::is_enum_v<FieldType>)
+	{
+		if constexpr (have_enum_meta_info<FieldType>::value)
+		{
+			const char* pVal = pVarE->Attribute("val");
+			if (pVal && static_reflection_v2::enum_from_string(pVal, *field))
+				return;
+		}
+		int64_t val = 0;
+		pVarE->QueryAttribute("val", &val);
+		*field = FieldType(val);
+	}
+	else
+	{
+		xmlElement_to_struct(pVarE, *field, resource);
+	}
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, uint64_t* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, uint64_t* field, std::pmr::memory_resource*)
 {
 	pVarE->QueryAttribute("val", (int64_t*)field);
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, unsigned* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, unsigned* field, std::pmr::memory_resource*)
 {
 	pVarE->QueryAttribute("val", field);
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, int* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, int* field, std::pmr::memory_resource*)
 {
 	pVarE->QueryAttribute("val", field);
 }
@@ -103,6 +143,15 @@ void xml_value_to_field(tinyxml2::XMLElement* pVarE, int* field, NameHash_tag ta
 	pVarE->QueryAttribute("val", field);
 }
 
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, std::string_view* field, static_reflection_v2::intern_tag)
+{
+	const char* pVal = pVarE->Attribute("val");
+	if (pVal)
+	{
+		static_reflection_v2::intern_to_field(pVal, *field);
+	}
+}
+
 void xml_value_to_field(tinyxml2::XMLElement* pVarE, int* field, std::function<void(tinyxml2::XMLElement*, int*)> after_func)
 {
 	pVarE->QueryAttribute("val", field);
@@ -112,31 +161,31 @@ void xml_value_to_field(tinyxml2::XMLElement* pVarE, int* field, std::function<v
 
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, int64_t* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, int64_t* field, std::pmr::memory_resource*)
 {
 	pVarE->QueryAttribute("val", field);
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, bool* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, bool* field, std::pmr::memory_resource*)
 {
 	pVarE->QueryAttribute("val", field);
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, double* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, double* field, std::pmr::memory_resource*)
 {
 	pVarE->QueryAttribute("val", field);
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, float* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, float* field, std::pmr::memory_resource*)
 {
 	pVarE->QueryAttribute("val", field);
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, std::string* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, std::string* field, std::pmr::memory_resource*)
 {
 	const char* pVal = pVarE->Attribute("val");
 	if (pVal)
@@ -146,7 +195,23 @@ void xml_value_to_field(tinyxml2::XMLElement* pVarE, std::string* field)
 }
 
 template<>
-void xml_value_to_field(tinyxml2::XMLElement* pVarE, ActionFlowOut* field)
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, std::pmr::string* field, std::pmr::memory_resource* resource)
+{
+	const char* pVal = pVarE->Attribute("val");
+	if (pVal)
+	{
+		//a pmr string keeps its resource for life, rebuild it on the requested one
+		if (resource != nullptr && field->get_allocator().resource() != resource)
+		{
+			std::destroy_at(field);
+			std::construct_at(field, resource);
+		}
+		field->assign(pVal);
+	}
+}
+
+template<>
+void xml_value_to_field(tinyxml2::XMLElement* pVarE, ActionFlowOut* field, std::pmr::memory_resource*)
 {
 	field->iOutCnt = 0;
 }
@@ -155,26 +220,19 @@ void xml_value_to_field(tinyxml2::XMLElement* pVarE, ActionFlowOut* field)
 struct ForEachXMLLambda
 {
     tinyxml2::XMLElement* pVarE;
-	const char* field_name;
-	std::size_t field_name_hash;
+	std::pmr::memory_resource* resource;
     template<typename FieldInfo, typename Field>
     bool operator()(FieldInfo&& this_field_info, Field&& this_field) const
     {
-		printf("test:%s\n", std::get<0>(this_field_info) );
-		if (field_name_hash != std::get<1>(this_field_info))
-			return false;
-		printf("vist:%s\n", std::get<0>(this_field_info));
-		xml_value_to_field(pVarE, &this_field);
+		printf("vist:%s\n", this_field_info.field_name);
+		xml_value_to_field(pVarE, &this_field, resource);
 		return true;
     }
 
 	template<typename FieldInfo, typename Field, typename Tag>
 	bool operator()(FieldInfo&& this_field_info, Field&& this_field, Tag&& tag) const
 	{
-		printf("test:%s\n", std::get<0>(this_field_info));
-		if (field_name_hash != std::get<1>(this_field_info))
-			return false;
-		printf("vist:%s\n", std::get<0>(this_field_info));
+		printf("vist:%s\n", this_field_info.field_name);
 		xml_value_to_field(pVarE, &this_field, std::forward<Tag>(tag) );
 		return true;
 	}
@@ -182,7 +240,7 @@ struct ForEachXMLLambda
 
 
 template<class T>
-void xmlElement_to_struct(tinyxml2::XMLElement* pE, T& refStruct)
+void xmlElement_to_struct(tinyxml2::XMLElement* pE, T& refStruct, std::pmr::memory_resource* resource)
 {
 	tinyxml2::XMLElement* pVarE = pE->FirstChildElement();
 	while (pVarE != NULL)
@@ -190,9 +248,7 @@ void xmlElement_to_struct(tinyxml2::XMLElement* pE, T& refStruct)
 		const char* pStrName = pVarE->Attribute("name");
 		if (pStrName != NULL)
 		{
-			std::string field_name = pStrName;
-			
-			FindInField(refStruct, ForEachXMLLambda{ pVarE, field_name.c_str(), hash::MurmurHash3::shash(field_name.c_str(), field_name.size(), 0) });
+			static_reflection_v2::FindInField(refStruct, static_reflection_v2::make_string_hash<T>(pStrName), ForEachXMLLambda{ pVarE, resource });
 		}
 
 
@@ -202,6 +258,36 @@ void xmlElement_to_struct(tinyxml2::XMLElement* pE, T& refStruct)
 }
 
 
+
+//the loader as it was before V2, over the V1 schema: a field matches when its "..."_H murmur hash equals the name's
+struct ForEachXMLLambdaV1
+{
+	tinyxml2::XMLElement* pVarE;
+	uint32_t name_hash;
+	template<typename FieldInfo, typename Field, typename... Extra>
+	bool operator()(FieldInfo&& this_field_info, Field&& this_field, Extra&&... extra) const
+	{
+		if (std::get<1>(this_field_info) != name_hash)
+			return false;
+		xml_value_to_field(pVarE, &this_field, std::forward<Extra>(extra)...);
+		return true;
+	}
+};
+
+template<class T>
+void xmlElement_to_struct_v1(tinyxml2::XMLElement* pE, T& refStruct)
+{
+	for (tinyxml2::XMLElement* pVarE = pE->FirstChildElement(); pVarE != NULL; pVarE = pVarE->NextSiblingElement())
+	{
+		const char* pStrName = pVarE->Attribute("name");
+		if (pStrName != NULL)
+		{
+			FindInField(refStruct, ForEachXMLLambdaV1{ pVarE, hash::MurmurHash3::shash(pStrName, strlen(pStrName), 0) });
+		}
+	}
+}
+
+
 int main(int argc, char *argv[] )
 {
 	const char* pstrFileName = argv[1];
@@ -228,10 +314,20 @@ int main(int argc, char *argv[] )
 	while(pNodeE)
 	{
 
-		std::string struct_name = pNodeE->Name();
-		//maybe find in map / global
 		ActionFlowNodeOneUnion testNode;
-		xmlElement_to_struct(pNodeE, testNode.stCast);
+		static_reflection_v2::CreateByName(testNode, pNodeE->Name(), [pNodeE](auto& node)
+		{
+			xmlElement_to_struct(pNodeE, node);
+
+			//both schemas bind "breakTime" to iWaitTimeQianYao and iWaitTimeMoveQianYao
+			if constexpr (std::is_same_v<std::decay_t<decltype(node)>, ActionFlowLCast>)
+			{
+				ActionFlowLCast nodeV1{};
+				xmlElement_to_struct_v1(pNodeE, nodeV1);
+				if (nodeV1.iWaitTimeQianYao != node.iWaitTimeQianYao || nodeV1.iWaitTimeMoveQianYao != node.iWaitTimeMoveQianYao)
+					printf("breakTime: V1 %d/%d, V2 %d/%d\n", nodeV1.iWaitTimeQianYao, nodeV1.iWaitTimeMoveQianYao, node.iWaitTimeQianYao, node.iWaitTimeMoveQianYao);
+			}
+		});
 
 
 		pNodeE = pNodeE->NextSiblingElement();